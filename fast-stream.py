@@ -13,6 +13,10 @@ import threading
 import time
 import signal
 import sys
+import re
+import struct
+import binascii
+import collections
 
 errorflg = False
 intrflg = False
@@ -31,11 +35,88 @@ parser = argparse.ArgumentParser(description='Stream g-code file to Smoothie ove
 parser.add_argument('gcode_file', type=argparse.FileType('r'), help='g-code filename to be streamed')
 parser.add_argument('device', help='Smoothie Serial Device')
 parser.add_argument('-q', '--quiet', action='store_true', default=False, help='suppress output text')
+parser.add_argument('-b', '--binary', action='store_true', default=False,
+                    help='send G0/G1 moves as binary frames, needs enable_binary_protocol true in config')
+parser.add_argument('-c', '--count', action='store_true', default=False,
+                    help='only send what fits in the receive buffer by counting the characters of the lines not yet ok\'d, needs ok_buffer_space true in config')
 args = parser.parse_args()
+if args.binary and args.count:
+    parser.error('binary frames get no ok so they can not be counted, use one or the other')
 
 f = args.gcode_file
 verbose = not args.quiet
 
+
+class BinaryEncoder:
+    """Turns G0/G1 lines into binary move frames, anything else is left to be sent as a line.
+    Tracks G90/G91, G20/G21 and the motion mode, as a binary move is always absolute and in mm"""
+
+    SYNC = 0xFD
+    MOVE = 1
+    LINEAR, HAS_FEED, HAS_S = 0x01, 0x02, 0x04
+    SCALE = 10000.0
+    AXES = 'XYZABC'
+    word = re.compile(r'([A-Z])\s*([-+]?[0-9]*\.?[0-9]*)')
+
+    def __init__(self):
+        self.absolute = True
+        self.inches = False
+        self.motion = None
+
+    @staticmethod
+    def frame(type, payload):
+        body = struct.pack('<BB', type, len(payload)) + payload
+        return struct.pack('<B', BinaryEncoder.SYNC) + body + struct.pack('<H', binascii.crc_hqx(body, 0xFFFF))
+
+    def encode(self, line):
+        """returns the frame for the line or None if it has to be sent as it is"""
+        words = self.word.findall(line.upper())
+        # only lines that are nothing but words, so comments, line numbers and checksums are sent as they are
+        if not words or ''.join(l + v for l, v in words) != re.sub(r'\s', '', line.upper()):
+            return None
+        try:
+            values = [(l, float(v)) for l, v in words]
+        except ValueError:
+            return None
+
+        gcodes = [v for l, v in values if l == 'G']
+        for g in gcodes:
+            if g in (0, 1, 2, 3):
+                self.motion = g
+            elif g in (90, 91):
+                self.absolute = g == 90
+            elif g in (20, 21):
+                self.inches = g == 20
+
+        if any(g not in (0, 1) for g in gcodes) or any(l not in 'G' + self.AXES + 'FS' for l, v in values):
+            return None
+        if not self.absolute or self.motion not in (0, 1) or not any(l in self.AXES for l, v in values):
+            return None
+
+        mm = 25.4 if self.inches else 1.0
+        flags = self.LINEAR if self.motion == 1 else 0
+        axes = 0
+        targets = {}
+        feed = s = b''
+        for l, v in values:
+            if l in self.AXES:
+                n = self.AXES.index(l)
+                axes |= 1 << n
+                targets[n] = v * (mm if n < 3 else 1.0)
+            elif l == 'F':
+                flags |= self.HAS_FEED
+                feed = struct.pack('<I', int(round(v * mm * self.SCALE)))
+            elif l == 'S':
+                flags |= self.HAS_S
+                s = struct.pack('<I', int(round(v * self.SCALE)))
+
+        # the targets go in axis order whatever order they were written in
+        payload = struct.pack('<BB', flags, axes)
+        for n in sorted(targets):
+            payload += struct.pack('<i', int(round(targets[n] * self.SCALE)))
+        return self.frame(self.MOVE, payload + feed + s)
+
+
 # Stream g-code to Smoothie
 
 dev = args.device
@@ -48,13 +129,26 @@ print("Streaming " + args.gcode_file.name + " to " + args.device)
 
 okcnt = 0
 
+# for --count, the size of the receive buffer and the lengths of the lines sent that have not been ok'd yet
+# ok and the reply to ? end with Bf:free planner blocks,free receive buffer bytes
+bufsize = 0
+blocks_free = 0
+inflight = collections.deque()
+credit = threading.Condition()
+bfre = re.compile(r'Bf:(\d+),(-?\d+)')
+
 
 def read_thread():
     """thread worker function"""
-    global okcnt, errorflg
+    global okcnt, errorflg, bufsize, blocks_free
     flag = 1
     while flag:
         rep = s.readline().decode('latin1')
+        m = bfre.search(rep)
+        if m:
+            blocks_free = int(m.group(1))
+            if bufsize == 0:
+                bufsize = int(m.group(2))  # the first is the reply to ? when nothing has been sent yet
         n = rep.count("ok")
         if n == 0:
             print("Incoming: " + rep)
@@ -63,6 +157,10 @@ def read_thread():
                 break
         else:
             okcnt += n
+            with credit:
+                for i in range(min(n, len(inflight))):
+                    inflight.popleft()
+                credit.notify()
 
     print("Read thread exited")
     return
@@ -73,7 +171,19 @@ t = threading.Thread(target=read_thread)
 t.daemon = True
 t.start()
 
+if args.count:
+    s.write(b'?')
+    for i in range(20):
+        if bufsize != 0:
+            break
+        time.sleep(0.1)
+    if bufsize <= 0:
+        print("Did not get the receive buffer size, is ok_buffer_space true in config?")
+        sys.exit(1)
+    print("Receive buffer is {} bytes".format(bufsize))
+
 linecnt = 0
+encoder = BinaryEncoder() if args.binary else None
 try:
     for line in f:
         if errorflg:
@@ -82,13 +192,26 @@ try:
         if line.startswith(';'):
             continue
         l = line.strip()
-        o = "{}\n".format(l).encode('latin1')
+        o = encoder.encode(l) if encoder else None
+        if o is None:
+            o = "{}\n".format(l).encode('latin1')
+            linecnt += 1  # moves sent as frames get no ok
+            if args.count:
+                # wait until the line fits in what is left of the receive buffer
+                with credit:
+                    while sum(inflight) + len(o) > bufsize and not errorflg:
+                        credit.wait(1)
+                    inflight.append(len(o))
         n = s.write(o)
         if n != len(o):
             print("Not entire line was sent: {} - {}".format(n, len(o)))
-        linecnt += 1
         if verbose:
-            print("SND " + str(linecnt) + ": " + line.strip() + " - " + str(okcnt))
+            print("SND " + str(linecnt) + ": " + line.strip() + " - " + str(okcnt) + (" blocks free " + str(blocks_free) if args.count else ""))
+
+    if encoder and not errorflg:
+        # the ok for this says all the moves before it have been taken
+        s.write(b'M400\n')
+        linecnt += 1
 
 except KeyboardInterrupt:
     print("Interrupted...")
@@ -0,0 +1,45 @@
+/*
+      This file is part of Smoothie (http://smoothieware.org/). The motion control part is heavily based on Grbl (https://github.com/simen/grbl).
+      Smoothie is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+      Smoothie is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+      You should have received a copy of the GNU General Public License along with Smoothie. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <stdint.h>
+#include <functional>
+
+// The virtual clock that replaces the LPC17xx timers in the simulator.
+// Time is kept in timer counts (SystemCoreClock/4, the same units the firmware programs into MR0).
+// Advancing the clock runs any timer match interrupts that fall due, in time order, exactly as
+// the NVIC would: TIMER1 (unstep) preempts TIMER0 (step), PendSV runs after both have returned.
+class SimClock {
+    public:
+        static uint64_t now() { return counts; }
+        static uint32_t micros() { return counts / counts_per_us(); }
+        static uint64_t counts_per_us() { return counts_per_second() / 1000000; }
+        static uint64_t counts_per_second();
+
+        // advance the clock running any interrupts that are due
+        static void advance(uint64_t delta_counts);
+        static void advance_us(uint32_t us) { advance((uint64_t)us * counts_per_us()); }
+
+        // called after each TIMER0 interrupt has been serviced, used to record the step timeline
+        static std::function<void()> after_step_isr;
+
+        static uint32_t timer0_interrupts() { return n_timer0; }
+        static uint32_t timer1_interrupts() { return n_timer1; }
+        static uint32_t pendsv_interrupts() { return n_pendsv; }
+
+    private:
+        static void sample_timer1();
+        static void run_pendsv();
+
+        static uint64_t counts;
+        static uint64_t timer0_next;
+        static uint64_t timer1_next;
+        static uint32_t n_timer0;
+        static uint32_t n_timer1;
+        static uint32_t n_pendsv;
+};
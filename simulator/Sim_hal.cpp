@@ -0,0 +1,166 @@
+/*
+      This file is part of Smoothie (http://smoothieware.org/). The motion control part is heavily based on Grbl (https://github.com/simen/grbl).
+      Smoothie is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+      Smoothie is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+      You should have received a copy of the GNU General Public License along with Smoothie. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/**
+This is part of the Smoothie host simulator, it emulates the LPC17xx peripherals and the interrupt
+controller used by the motion pipeline, driven by a virtual clock so runs are fully deterministic.
+*/
+
+#include "SimClock.h"
+
+#include "sim_lpc17xx.h"
+#include "mri.h"
+#include "wait_api.h"
+#include "us_ticker_api.h"
+#include "MRI_Hooks.h"
+#include "port_api.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <algorithm>
+
+// peripheral register blocks
+LPC_GPIO_TypeDef   sim_gpio[5];
+LPC_TIM_TypeDef    sim_tim[4];
+LPC_SC_TypeDef     sim_sc;
+LPC_PINCON_TypeDef sim_pincon;
+LPC_WDT_TypeDef    sim_wdt;
+SCB_Type           sim_scb;
+uint32_t SystemCoreClock = 100000000;
+uint32_t sim_dwt_ctrl;
+uint32_t sim_demcr;
+
+static bool nvic_enabled[NUM_SIM_IRQn];
+
+// interrupt handlers provided by the firmware
+extern "C" void TIMER0_IRQHandler(void);
+extern "C" void TIMER1_IRQHandler(void);
+extern "C" void PendSV_Handler(void);
+
+#define NEVER UINT64_MAX
+
+uint64_t SimClock::counts= 0;
+uint64_t SimClock::timer0_next= NEVER;
+uint64_t SimClock::timer1_next= NEVER;
+uint32_t SimClock::n_timer0= 0;
+uint32_t SimClock::n_timer1= 0;
+uint32_t SimClock::n_pendsv= 0;
+std::function<void()> SimClock::after_step_isr;
+
+uint64_t SimClock::counts_per_second()
+{
+    // SystemCoreClock/4 = Timer increments in a second
+    return SystemCoreClock / 4;
+}
+
+static bool timer0_enabled()
+{
+    return nvic_enabled[TIMER0_IRQn] && (LPC_TIM0->TCR & 1) != 0 && LPC_TIM0->MR0 > 0;
+}
+
+// the unstep timer is started by writing TCR, it stops on match (MCR=5) so we consume the start here
+void SimClock::sample_timer1()
+{
+    if(LPC_TIM1->TCR & 1) {
+        timer1_next= counts + std::max<uint32_t>((uint32_t)LPC_TIM1->MR0, 1);
+        LPC_TIM1->TCR= 0;
+    }
+}
+
+void SimClock::run_pendsv()
+{
+    if(SCB->ICSR & SCB_ICSR_PENDSVSET_Msk) {
+        SCB->ICSR &= ~SCB_ICSR_PENDSVSET_Msk;
+        ++n_pendsv;
+        PendSV_Handler();
+    }
+}
+
+void SimClock::advance(uint64_t delta_counts)
+{
+    uint64_t target= counts + delta_counts;
+
+    for(;;) {
+        if(timer0_next == NEVER && timer0_enabled()) timer0_next= counts + LPC_TIM0->MR0;
+
+        uint64_t next= std::min(timer0_next, timer1_next);
+        if(next > target) break;
+        counts= next;
+
+        if(timer1_next <= timer0_next) {
+            // TIMER1 has the higher priority so it is serviced first if both are due
+            timer1_next= NEVER;
+            ++n_timer1;
+            if(nvic_enabled[TIMER1_IRQn]) TIMER1_IRQHandler();
+
+        }else{
+            ++n_timer0;
+            TIMER0_IRQHandler();
+            // match resets the counter (MCR=3) so any new MR0 written by the ISR is the next period
+            timer0_next= timer0_enabled() ? counts + std::max<uint32_t>((uint32_t)LPC_TIM0->MR0, 1) : NEVER;
+            sample_timer1();
+            if(after_step_isr) after_step_isr();
+        }
+
+        // PendSV has the lowest priority so it runs once the timer ISRs have returned
+        run_pendsv();
+    }
+
+    counts= target;
+}
+
+extern "C" {
+
+void NVIC_EnableIRQ(IRQn_Type irq) { if(irq >= 0) nvic_enabled[irq]= true; }
+void NVIC_DisableIRQ(IRQn_Type irq) { if(irq >= 0) nvic_enabled[irq]= false; }
+void NVIC_SetPriority(IRQn_Type irq, uint32_t priority) {}
+uint32_t NVIC_GetPriority(IRQn_Type irq) { return 0; }
+void NVIC_SetPriorityGrouping(uint32_t grouping) {}
+
+void NVIC_SetPendingIRQ(IRQn_Type irq)
+{
+    if(irq == PendSV_IRQn) SCB->ICSR |= SCB_ICSR_PENDSVSET_Msk;
+}
+
+void NVIC_SystemReset(void)
+{
+    fprintf(stderr, "FATAL: system reset requested\n");
+    exit(1);
+}
+
+void __debugbreak(void)
+{
+    fprintf(stderr, "FATAL: __debugbreak() at %.2f us\n", (double)SimClock::now() / SimClock::counts_per_us());
+    abort();
+}
+
+uint32_t *sim_dwt_cyccnt(void)
+{
+    static uint32_t cyccnt;
+    cyccnt= SimClock::now() * 4;
+    return &cyccnt;
+}
+
+uint32_t us_ticker_read(void)
+{
+    return SimClock::micros();
+}
+
+// a busy wait lets the interrupts run so it advances the virtual clock
+void wait_us(int us) { SimClock::advance_us(us); }
+void wait_ms(int ms) { SimClock::advance_us(ms * 1000); }
+void wait(float s) { SimClock::advance_us(s * 1000000.0F); }
+
+PinName port_pin(PortName port, int pin_n)
+{
+    return (PinName)(LPC_GPIO0_BASE + ((port << PORT_SHIFT) | pin_n));
+}
+
+void set_high_on_debug(int port, int pin) {}
+void set_low_on_debug(int port, int pin) {}
+
+}
@@ -0,0 +1,221 @@
+/*
+      This file is part of Smoothie (http://smoothieware.org/). The motion control part is heavily based on Grbl (https://github.com/simen/grbl).
+      Smoothie is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+      Smoothie is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+      You should have received a copy of the GNU General Public License along with Smoothie. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/**
+This is part of the Smoothie host simulator, it provides a Kernel that only builds the motion pipeline
+(GcodeDispatch -> Robot -> Planner -> Conveyor -> StepTicker) and loads its config from a file on the host.
+Modelled on the Kernel in the test framework.
+*/
+
+#include "Sim_kernel.h"
+#include "SimClock.h"
+
+#include "libs/Kernel.h"
+#include "libs/Module.h"
+#include "libs/Config.h"
+#include "libs/nuts_bolts.h"
+#include "libs/StreamOutputPool.h"
+#include "checksumm.h"
+#include "ConfigValue.h"
+
+#include "libs/StepTicker.h"
+#include "libs/PublicData.h"
+#include "modules/communication/GcodeDispatch.h"
+#include "modules/robot/Planner.h"
+#include "modules/robot/Robot.h"
+#include "modules/robot/Conveyor.h"
+#include "StepperMotor.h"
+#include "SimpleShell.h"
+#include "ToolManager.h"
+
+#include "FileConfigSource.h"
+
+#include <stdio.h>
+#include <string>
+
+#define base_stepping_frequency_checksum            CHECKSUM("base_stepping_frequency")
+#define microseconds_per_step_pulse_checksum        CHECKSUM("microseconds_per_step_pulse")
+#define event_driven_stepping_checksum              CHECKSUM("event_driven_stepping")
+#define grbl_mode_checksum                          CHECKSUM("grbl_mode")
+#define feed_hold_enable_checksum                   CHECKSUM("enable_feed_hold")
+#define ok_per_line_checksum                        CHECKSUM("ok_per_line")
+#define ok_buffer_space_checksum                    CHECKSUM("ok_buffer_space")
+
+Kernel* Kernel::instance;
+
+// the default config is linked into the firmware binary, the simulator always uses a config file instead
+char _binary_config_default_start;
+char _binary_config_default_end;
+
+static const char *sim_config_file= nullptr;
+static uint32_t sim_idle_us= 10;
+
+// everything the firmware prints goes to stderr so stdout can carry the step timeline
+class SimStream : public StreamOutput {
+    public:
+        int puts(const char *s) { if(!quiet) fputs(s, stderr); return strlen(s); }
+        bool quiet{false};
+};
+
+static SimStream sim_stream;
+
+void sim_kernel_setup_config(const char *filename)
+{
+    sim_config_file= filename;
+}
+
+void sim_kernel_set_idle_time(uint32_t us)
+{
+    sim_idle_us= us;
+}
+
+void sim_kernel_set_quiet(bool q)
+{
+    sim_stream.quiet= q;
+}
+
+StreamOutput *sim_kernel_stream()
+{
+    return &sim_stream;
+}
+
+// The kernel is the central point in Smoothie : it stores modules, and handles event calls
+Kernel::Kernel()
+{
+    halted = false;
+    feed_hold = false;
+    enable_feed_hold = false;
+    enable_binary_protocol = false;
+    ok_buffer_space = false;
+    bad_mcu= false;
+    use_leds= false;
+
+    instance = this; // setup the Singleton instance of the kernel
+
+    this->serial = nullptr;
+    this->slow_ticker = nullptr;
+    this->adc = nullptr;
+    this->simpleshell = nullptr;
+    this->tool_manager = nullptr;
+    this->configurator = nullptr;
+
+    this->streams = new StreamOutputPool();
+    this->streams->append_stream(&sim_stream);
+
+    // loads the config from a file on the host instead of the sdcard
+    this->config = new Config(new FileConfigSource(sim_config_file, "sim"));
+    this->config->config_cache_load();
+
+    this->current_path   = "/";
+
+    this->grbl_mode = this->config->value( grbl_mode_checksum )->by_default(false)->as_bool();
+    this->enable_feed_hold = this->config->value( feed_hold_enable_checksum )->by_default(this->grbl_mode)->as_bool();
+    this->ok_per_line = this->config->value( ok_per_line_checksum )->by_default(true)->as_bool();
+    this->ok_buffer_space = this->config->value( ok_buffer_space_checksum )->by_default(false)->as_bool();
+
+    this->step_ticker = new StepTicker();
+
+    // Configure the step ticker
+    this->base_stepping_frequency = this->config->value(base_stepping_frequency_checksum)->by_default(100000)->as_number();
+    float microseconds_per_step_pulse = this->config->value(microseconds_per_step_pulse_checksum)->by_default(1)->as_number();
+
+    this->step_ticker->set_frequency( this->base_stepping_frequency );
+    this->step_ticker->set_unstep_time( microseconds_per_step_pulse );
+    // only interrupt when a step is due instead of on every tick
+    this->step_ticker->set_event_driven( this->config->value(event_driven_stepping_checksum)->by_default(false)->as_bool() );
+
+    // Core modules
+    this->add_module( this->conveyor       = new Conveyor()      );
+    this->add_module( this->gcode_dispatch = new GcodeDispatch() );
+    this->add_module( this->robot          = new Robot()         );
+
+    this->planner = new Planner();
+}
+
+std::string Kernel::get_query_string(StreamOutput *stream)
+{
+    return std::string("<") + (halted ? "Alarm" : feed_hold ? "Hold" : conveyor->is_idle() ? "Idle" : "Run") + ">\n";
+}
+
+// Add a module to Kernel. We don't actually hold a list of modules we just call its on_module_loaded
+void Kernel::add_module(Module* module)
+{
+    module->on_module_loaded();
+}
+
+// Adds a hook for a given module and event
+void Kernel::register_for_event(_EVENT_ENUM id_event, Module *mod)
+{
+    this->hooks[id_event].push_back(mod);
+}
+
+void Kernel::immediate_halt()
+{
+    this->halted = true;
+    conveyor->flush_queue(); // make sure no queued up codes get through
+    for(auto &a : robot->actuators) a->stop_moving();
+}
+
+// Call a specific event with an argument
+void Kernel::call_event(_EVENT_ENUM id_event, void * argument)
+{
+    bool was_idle = true;
+    if(id_event == ON_HALT) {
+        this->halted = (argument == nullptr);
+        if(!this->halted && this->feed_hold) this->feed_hold= false; // also clear feed hold
+        was_idle = conveyor->is_idle(); // see if we were doing anything like printing
+    }
+
+    // send to all registered modules
+    for (auto m : hooks[id_event]) {
+        (m->*kernel_callback_functions[id_event])(argument);
+    }
+
+    if(id_event == ON_IDLE) {
+        // every pass round the main loop takes some time, this is when the interrupts get to run
+        SimClock::advance_us(sim_idle_us);
+
+    }else if(id_event == ON_HALT) {
+        if(!this->halted || !was_idle) {
+            this->robot->reset_position_from_current_actuator_position();
+        }
+    }
+}
+
+bool Kernel::kernel_has_event(_EVENT_ENUM id_event, Module *mod)
+{
+    for (auto m : hooks[id_event]) {
+        if(m == mod) return true;
+    }
+    return false;
+}
+
+void Kernel::unregister_for_event(_EVENT_ENUM id_event, Module *mod)
+{
+    for (auto i = hooks[id_event].begin(); i != hooks[id_event].end(); ++i) {
+        if(*i == mod) {
+            hooks[id_event].erase(i);
+            return;
+        }
+    }
+}
+
+// there is no shell or tool changer in the simulator
+bool SimpleShell::parse_command(const char *cmd, string args, StreamOutput *stream)
+{
+    return false;
+}
+
+const float *ToolManager::get_tool_offset(unsigned int tool)
+{
+    static const float zero[3]= {0, 0, 0};
+    return zero;
+}
+
+void ToolManager::set_tool_offset(unsigned int tool, float offset[3])
+{
+}
@@ -0,0 +1,21 @@
+/*
+      This file is part of Smoothie (http://smoothieware.org/). The motion control part is heavily based on Grbl (https://github.com/simen/grbl).
+      Smoothie is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+      Smoothie is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+      You should have received a copy of the GNU General Public License along with Smoothie. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <stdint.h>
+
+class StreamOutput;
+
+// must be called before the Kernel is created
+void sim_kernel_setup_config(const char *filename);
+
+// how long one pass round the main loop (ON_IDLE) takes in simulated time
+void sim_kernel_set_idle_time(uint32_t us);
+// suppress the firmware output
+void sim_kernel_set_quiet(bool q);
+StreamOutput *sim_kernel_stream();
@@ -0,0 +1,244 @@
+/*
+      This file is part of Smoothie (http://smoothieware.org/). The motion control part is heavily based on Grbl (https://github.com/simen/grbl).
+      Smoothie is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+      Smoothie is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+      You should have received a copy of the GNU General Public License along with Smoothie. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/**
+Host simulator for the Smoothie motion pipeline.
+Replays a gcode file through GcodeDispatch -> Robot -> Planner -> Conveyor -> StepTicker against a virtual clock
+and writes the resulting per motor step/dir timeline, followed by a summary of throughput, block starvation and step timing.
+*/
+
+#include "SimClock.h"
+#include "Sim_kernel.h"
+
+#include "libs/Kernel.h"
+#include "libs/StepTicker.h"
+#include "libs/StepperMotor.h"
+#include "libs/SerialMessage.h"
+#include "libs/StreamOutput.h"
+#include "modules/robot/Conveyor.h"
+#include "modules/robot/Robot.h"
+#include "modules/communication/BinaryProtocol.h"
+#include "platform_memory.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <vector>
+#include <string>
+
+// stand in for the AHB SRAM banks, 16K each like the LPC1769
+static uint8_t ahb0_ram[16384] __attribute__ ((aligned (8)));
+static uint8_t ahb1_ram[16384] __attribute__ ((aligned (8)));
+
+// only print replies that are not plain ok, so errors from the gcode file are seen
+class ReplyStream : public StreamOutput {
+    public:
+        int puts(const char *s) {
+            if(strncmp(s, "ok", 2) != 0 || strlen(s) > 4) sim_kernel_stream()->puts(s);
+            return strlen(s);
+        }
+};
+
+struct MotorStats {
+    uint32_t last_step;
+    uint64_t steps{0};
+    uint64_t last_step_time{0};
+    uint64_t min_interval{UINT64_MAX};
+    uint32_t direction_changes{0};
+    bool last_dir{false};
+};
+
+static struct {
+    std::vector<MotorStats> motors;
+    const Block *last_block{nullptr};
+    uint32_t blocks{0};
+    uint64_t first_block_time{0};
+    uint64_t last_block_end{0};
+    uint64_t idle_since{0};
+    uint32_t starved{0};
+    uint64_t starved_time{0};
+    uint64_t max_starved_time{0};
+    FILE *timeline{nullptr};
+} stats;
+
+static double to_us(uint64_t counts)
+{
+    return (double)counts / SimClock::counts_per_us();
+}
+
+// called after every step tick, records any step that was issued and tracks block changes
+static void sample_step_isr()
+{
+    uint64_t now= SimClock::now();
+    for (size_t i = 0; i < stats.motors.size(); ++i) {
+        MotorStats& m= stats.motors[i];
+        uint32_t pos= THEROBOT->actuators[i]->get_current_step();
+        if(pos == m.last_step) continue;
+
+        bool dir= (int32_t)(pos - m.last_step) < 0;
+        m.last_step= pos;
+        if(m.steps > 0) {
+            uint64_t interval= now - m.last_step_time;
+            if(interval < m.min_interval) m.min_interval= interval;
+            if(dir != m.last_dir) ++m.direction_changes;
+        }
+        m.last_dir= dir;
+        m.last_step_time= now;
+        ++m.steps;
+        if(stats.timeline != nullptr) fprintf(stats.timeline, "%1.2f,%u,%d\n", to_us(now), (unsigned)i, dir ? 1 : 0);
+    }
+
+    const Block *b= THEKERNEL->step_ticker->get_current_block();
+    if(b == stats.last_block) return;
+
+    if(b != nullptr) {
+        if(stats.blocks == 0) {
+            stats.first_block_time= now;
+
+        }else if(stats.last_block == nullptr) {
+            // the step ticker ran dry between two blocks, this includes any deliberate waits like G4 or M400
+            uint64_t gap= now - stats.idle_since;
+            ++stats.starved;
+            stats.starved_time += gap;
+            if(gap > stats.max_starved_time) stats.max_starved_time= gap;
+        }
+        ++stats.blocks;
+
+    }else{
+        stats.idle_since= now;
+        stats.last_block_end= now;
+    }
+    stats.last_block= b;
+}
+
+static void print_summary(uint32_t lines)
+{
+    double run_time= to_us(stats.last_block_end - stats.first_block_time) / 1e6;
+    fprintf(stderr, "\n--- simulation summary ---\n");
+    fprintf(stderr, "simulated time: %1.6f s, lines: %u, blocks executed: %u\n", to_us(SimClock::now()) / 1e6, lines, stats.blocks);
+    fprintf(stderr, "motion time: %1.6f s, %1.1f blocks/s\n", run_time, run_time > 0 ? stats.blocks / run_time : 0);
+    fprintf(stderr, "starvation: %u times, total %1.3f ms, longest %1.3f ms\n", stats.starved, to_us(stats.starved_time) / 1000, to_us(stats.max_starved_time) / 1000);
+    fprintf(stderr, "conveyor starvations: %u (queue_starvation_time_ms)\n", (unsigned)THECONVEYOR->get_starvation_count());
+    fprintf(stderr, "interrupts: step %u, unstep %u, pendsv %u\n", SimClock::timer0_interrupts(), SimClock::timer1_interrupts(), SimClock::pendsv_interrupts());
+    for (size_t i = 0; i < stats.motors.size(); ++i) {
+        MotorStats& m= stats.motors[i];
+        StepperMotor *a= THEROBOT->actuators[i];
+        fprintf(stderr, "motor %u: steps %llu, position %1.4f, direction changes %u", (unsigned)i, (unsigned long long)m.steps, a->get_current_position(), m.direction_changes);
+        if(m.min_interval != UINT64_MAX) {
+            fprintf(stderr, ", min step interval %1.2f us (%1.0f steps/s)", to_us(m.min_interval), 1e6 / to_us(m.min_interval));
+        }
+        fprintf(stderr, "\n");
+    }
+}
+
+static void usage(const char *name)
+{
+    fprintf(stderr, "Usage: %s -c config [-o timeline.csv] [-i main_loop_us] [-q] file.gcode\n", name);
+    fprintf(stderr, "  -c config       smoothie config file to use\n");
+    fprintf(stderr, "  -o timeline     write the step timeline (time_us,motor,dir) to this file, - for stdout\n");
+    fprintf(stderr, "  -i us           simulated time taken by one pass round the main loop (default 10)\n");
+    fprintf(stderr, "  -q              do not print firmware output\n");
+    exit(1);
+}
+
+int main(int argc, char *argv[])
+{
+    const char *config_file= nullptr;
+    const char *timeline_file= nullptr;
+    bool quiet= false;
+    int c;
+    while ((c = getopt(argc, argv, "c:o:i:q")) != -1) {
+        switch(c) {
+            case 'c': config_file= optarg; break;
+            case 'o': timeline_file= optarg; break;
+            case 'i': sim_kernel_set_idle_time(strtoul(optarg, nullptr, 10)); break;
+            case 'q': quiet= true; break;
+            default: usage(argv[0]);
+        }
+    }
+    if(config_file == nullptr || optind != argc-1) usage(argv[0]);
+
+    FILE *gcode_file= fopen(argv[optind], "r");
+    if(gcode_file == nullptr) {
+        perror(argv[optind]);
+        return 1;
+    }
+
+    if(timeline_file != nullptr) {
+        stats.timeline= strcmp(timeline_file, "-") == 0 ? stdout : fopen(timeline_file, "w");
+        if(stats.timeline == nullptr) {
+            perror(timeline_file);
+            return 1;
+        }
+        fprintf(stats.timeline, "time_us,motor,dir\n");
+    }
+
+    MemoryPool ahb0(ahb0_ram, sizeof(ahb0_ram)-1);
+    MemoryPool ahb1(ahb1_ram, sizeof(ahb1_ram)-1);
+    _AHB0= &ahb0;
+    _AHB1= &ahb1;
+
+    sim_kernel_set_quiet(quiet);
+    sim_kernel_setup_config(config_file);
+    Kernel *kernel= new Kernel();
+
+    // same as the end of init() in main.cpp
+    kernel->conveyor->start(THEROBOT->get_number_registered_motors());
+    kernel->step_ticker->start();
+
+    stats.motors.resize(THEROBOT->get_number_registered_motors());
+    for (size_t i = 0; i < stats.motors.size(); ++i) {
+        stats.motors[i].last_step= THEROBOT->actuators[i]->get_current_step();
+    }
+    SimClock::after_step_isr= sample_step_isr;
+
+    // feed the file one line per pass round the main loop, the same as playing it from the sdcard
+    // it may also have binary frames between the lines, like the USB serial takes when enable_binary_protocol is set
+    ReplyStream reply;
+    char buf[256];
+    uint32_t lines= 0;
+    int first;
+    while((first= getc(gcode_file)) != EOF && !kernel->is_halted()) {
+        if(first == BinaryProtocol::sync) {
+            uint8_t frame[BinaryProtocol::max_payload + BinaryProtocol::overhead];
+            frame[0]= first;
+            size_t len= 1 + fread(&frame[1], 1, 2, gcode_file);
+            if(len == 3 && frame[2] <= BinaryProtocol::max_payload) {
+                len += fread(&frame[3], 1, frame[2] + 2, gcode_file);
+            }
+            ++lines;
+            BinaryProtocol::handle_frame(frame, len, &reply);
+            kernel->call_event(ON_MAIN_LOOP);
+            kernel->call_event(ON_IDLE);
+            continue;
+        }
+        ungetc(first, gcode_file);
+        if(fgets(buf, sizeof(buf), gcode_file) == nullptr) break;
+
+        size_t len= strlen(buf);
+        while(len > 0 && (buf[len-1] == '\n' || buf[len-1] == '\r')) buf[--len]= '\0';
+        ++lines;
+        if(len == 0) continue;
+
+        SerialMessage message;
+        message.message = buf;
+        message.stream = &reply;
+        kernel->call_event(ON_CONSOLE_LINE_RECEIVED, &message);
+        kernel->call_event(ON_MAIN_LOOP);
+        kernel->call_event(ON_IDLE);
+    }
+    fclose(gcode_file);
+
+    kernel->conveyor->wait_for_idle();
+
+    if(stats.timeline != nullptr && stats.timeline != stdout) fclose(stats.timeline);
+
+    print_summary(lines);
+
+    return kernel->is_halted() ? 2 : 0;
+}
@@ -0,0 +1,25 @@
+/*
+      This file is part of Smoothie (http://smoothieware.org/). The motion control part is heavily based on Grbl (https://github.com/simen/grbl).
+      Smoothie is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+      Smoothie is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+      You should have received a copy of the GNU General Public License along with Smoothie. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+// simulator: pin interrupts never fire
+#pragma once
+
+#include "PinNames.h"
+
+namespace mbed {
+
+class InterruptIn {
+public:
+    InterruptIn(PinName pin) {}
+    template<typename T> void rise(T *tptr, void (T::*mptr)(void)) {}
+    template<typename T> void fall(T *tptr, void (T::*mptr)(void)) {}
+    void rise(void (*fptr)(void)) {}
+    void fall(void (*fptr)(void)) {}
+    void mode(int pull) {}
+};
+
+} // namespace mbed
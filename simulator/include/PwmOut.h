@@ -0,0 +1,33 @@
+/*
+      This file is part of Smoothie (http://smoothieware.org/). The motion control part is heavily based on Grbl (https://github.com/simen/grbl).
+      Smoothie is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+      Smoothie is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+      You should have received a copy of the GNU General Public License along with Smoothie. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+// simulator: hardware PWM is accepted and ignored
+#pragma once
+
+#include "PinNames.h"
+
+namespace mbed {
+
+class PwmOut {
+public:
+    PwmOut(PinName pin) : value(0) {}
+    void write(float v) { value= v; }
+    float read() { return value; }
+    void period(float seconds) {}
+    void period_ms(int ms) {}
+    void period_us(int us) {}
+    void pulsewidth(float seconds) {}
+    void pulsewidth_ms(int ms) {}
+    void pulsewidth_us(int us) {}
+    PwmOut& operator= (float v) { write(v); return *this; }
+    operator float() { return read(); }
+
+private:
+    float value;
+};
+
+} // namespace mbed
@@ -0,0 +1,27 @@
+/*
+      This file is part of Smoothie (http://smoothieware.org/). The motion control part is heavily based on Grbl (https://github.com/simen/grbl).
+      Smoothie is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+      Smoothie is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+      You should have received a copy of the GNU General Public License along with Smoothie. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+// simulator: the subset of mbed.h used by the motion pipeline
+#pragma once
+
+#include "sim_lpc17xx.h"
+#include "PinNames.h"
+#include "wait_api.h"
+#include "us_ticker_api.h"
+#include "PwmOut.h"
+#include "InterruptIn.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <string>
+#include <vector>
+
+// the same as the real mbed.h
+using namespace mbed;
+using namespace std;
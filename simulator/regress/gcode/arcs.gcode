@@ -0,0 +1,11 @@
+G21
+G90
+G1 X20 Y20 F6000
+G2 X40 Y20 I10 J0 F3000
+G3 X20 Y20 I-10 J0
+G2 X20 Y20 I5 J5
+G1 X0 Y0
+G2 X0.5 Y0.5 I0.25 J0.25 Z1
+G1 X30 Y30 Z0
+G3 X30 Y30 I-12 J3
+M400
@@ -0,0 +1,8 @@
+G21
+G90
+G1 X10 Y5 F3000
+G1 X20 Y20
+G1 X0 Y0 Z1
+G2 X10 Y0 I5 J0
+G4 P100
+G0 X50 Y50
@@ -0,0 +1,6 @@
+G21
+G90
+G1 X20 Y20 F6000
+M400
+G2 X20 Y20 I10 J3 F3000
+M400
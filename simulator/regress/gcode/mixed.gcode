@@ -0,0 +1,404 @@
+G21
+G90
+G1 F6000
+G1 X0.378 Y0.258
+G1 X0.474 Y0.328
+G0 X12.023 Y-15.918 F3000
+G2 X12.023 Y-15.918 I-1.102 J1.074
+G0 X19.857 Y-25.264 F3000
+G1 X19.638 Y-25.274
+G1 X19.858 Y-25.468
+G2 X19.858 Y-25.468 I1.865 J4.690
+G0 X20.963 Y-14.920 F12000
+G1 X20.940 Y-14.714
+G0 X39.029 Y2.346 F12000
+G2 X39.029 Y2.346 I0.565 J1.423
+G1 X39.524 Y2.662
+G1 X39.490 Y2.895
+G0 X56.947 Y-0.221 F3000
+G1 X57.117 Y0.109
+G2 X57.117 Y0.109 I0.053 J0.890
+G1 X57.012 Y0.387
+G1 X56.850 Y0.516
+G0 X63.829 Y-4.496 F12000
+G0 X48.147 Y-17.948 F12000
+G1 X48.433 Y-17.866
+G1 X48.811 Y-17.697
+G1 X49.029 Y-17.796
+G1 X48.739 Y-17.876
+G1 X49.739 Y-16.876 Z1.645 F6000
+G1 X50.201 Y-16.730
+G1 X50.116 Y-16.601
+G1 X51.116 Y-15.601 Z0.017 F600
+G1 X51.266 Y-15.545
+G1 X51.662 Y-15.403
+G1 X51.765 Y-15.312
+G1 X51.742 Y-15.189
+G0 X56.240 Y-16.863 F3000
+G2 X56.240 Y-16.863 I1.354 J0.508
+G1 X56.014 Y-16.733
+G2 X56.014 Y-16.733 I4.310 J-4.675
+G1 X57.014 Y-15.733 Z0.211 F600
+G1 X57.317 Y-15.764
+G1 X57.655 Y-15.853
+G1 X57.489 Y-15.900
+G1 X58.489 Y-14.900 Z1.970 F6000
+G1 X58.446 Y-14.816
+G1 X58.456 Y-14.763
+G1 X58.243 Y-14.423
+G1 X58.110 Y-14.260
+G2 X58.110 Y-14.260 I-4.792 J-4.821
+G1 X58.385 Y-14.364
+G0 X65.512 Y-12.576 F3000
+G1 X66.512 Y-11.576 Z1.892 F6000
+G1 X66.731 Y-11.539
+G1 X66.688 Y-11.360
+G1 X66.627 Y-10.979
+G2 X66.627 Y-10.979 I-1.936 J3.585
+G1 X67.078 Y-10.733
+G1 X66.980 Y-10.928
+G2 X66.980 Y-10.928 I-4.621 J3.194
+G1 X67.980 Y-9.928 Z1.711 F600
+G2 X67.980 Y-9.928 I3.699 J2.800
+G0 X49.477 Y-21.912 F3000
+G1 X49.716 Y-21.852
+G1 X49.500 Y-21.652
+G1 X49.600 Y-21.657
+G2 X49.600 Y-21.657 I3.997 J-4.819
+G1 X49.562 Y-21.265
+G0 X43.126 Y-32.744 F3000
+G2 X43.126 Y-32.744 I4.322 J-1.562
+G2 X43.126 Y-32.744 I1.871 J-0.155
+G1 X44.126 Y-31.744 Z0.704 F600
+G1 X43.961 Y-31.397
+G1 X44.269 Y-31.237
+G2 X44.269 Y-31.237 I-1.319 J-1.597
+G1 X44.663 Y-31.075
+G1 X45.663 Y-30.075 Z2.662 F600
+G1 X45.979 Y-30.082
+G1 X45.983 Y-29.688
+G1 X45.783 Y-29.819
+G1 X46.224 Y-29.973
+G1 X46.377 Y-29.601
+G1 X46.313 Y-29.481
+G1 X46.731 Y-29.616
+G1 X46.667 Y-29.448
+G1 X46.698 Y-29.152
+G0 X34.215 Y-17.732 F12000
+G1 X34.276 Y-17.523
+G1 X34.652 Y-17.462
+G1 X35.652 Y-16.462 Z2.419 F6000
+G1 X35.921 Y-16.474
+G1 X35.875 Y-16.657
+G0 X52.899 Y-7.598 F12000
+G1 X52.850 Y-7.760
+G1 X53.850 Y-6.760 Z2.909 F6000
+G1 X53.722 Y-6.589
+G1 X54.722 Y-5.589 Z1.629 F6000
+G0 X45.085 Y-3.925 F12000
+G1 X45.074 Y-3.633
+G1 X45.376 Y-3.779
+G1 X45.347 Y-3.843
+G1 X46.347 Y-2.843 Z0.123 F600
+G1 X46.725 Y-2.506
+G1 X46.692 Y-2.380
+G1 X46.869 Y-2.433
+G1 X46.764 Y-2.589
+G1 X46.521 Y-2.744
+G0 X38.154 Y8.943 F12000
+G1 X38.541 Y8.804
+G0 X31.665 Y9.174 F3000
+G1 X31.484 Y9.059
+G2 X31.484 Y9.059 I-1.944 J2.093
+G2 X31.484 Y9.059 I1.019 J-3.737
+G1 X31.621 Y9.293
+G0 X44.462 Y14.234 F3000
+G1 X44.508 Y14.129
+G0 X51.219 Y4.232 F3000
+G0 X49.087 Y1.439 F12000
+G1 X49.468 Y1.511
+G1 X49.439 Y1.466
+G1 X49.656 Y1.516
+G1 X49.406 Y1.529
+G1 X49.206 Y1.484
+G2 X49.206 Y1.484 I-1.022 J-0.989
+G0 X38.547 Y-18.217 F12000
+G1 X38.766 Y-18.154
+G0 X48.023 Y-28.619 F12000
+G0 X66.285 Y-20.105 F12000
+G1 X66.710 Y-19.754
+G1 X66.928 Y-19.925
+G1 X67.037 Y-19.599
+G1 X67.350 Y-19.269
+G1 X67.604 Y-18.960
+G1 X67.865 Y-18.718
+G1 X68.250 Y-18.380
+G1 X69.250 Y-17.380 Z1.714 F600
+G1 X69.291 Y-17.015
+G0 X80.582 Y-17.214 F12000
+G0 X74.501 Y-16.612 F3000
+G1 X74.997 Y-16.497
+G1 X74.901 Y-16.636
+G0 X58.250 Y2.356 F3000
+G1 X58.689 Y2.739
+G1 X59.031 Y2.799
+G1 X58.992 Y2.675
+G1 X59.992 Y3.675 Z2.878 F600
+G1 X60.119 Y4.020
+G0 X51.226 Y-0.826 F3000
+G1 X52.226 Y0.174 Z1.585 F600
+G1 X52.704 Y0.120
+G1 X52.543 Y0.009
+G1 X52.491 Y0.263
+G2 X52.491 Y0.263 I-0.536 J3.612
+G2 X52.491 Y0.263 I-3.320 J-1.430
+G1 X52.289 Y0.188
+G2 X52.289 Y0.188 I-2.952 J3.106
+G1 X53.289 Y1.188 Z0.072 F600
+G1 X53.761 Y1.445
+G1 X54.761 Y2.445 Z0.410 F6000
+G1 X54.710 Y2.547
+G1 X54.833 Y2.347
+G1 X54.892 Y2.330
+G1 X55.219 Y2.540
+G1 X55.437 Y2.567
+G1 X55.140 Y2.533
+G1 X55.545 Y2.831
+G1 X56.035 Y2.908
+G2 X56.035 Y2.908 I-0.910 J2.446
+G1 X57.035 Y3.908 Z0.916 F600
+G1 X57.270 Y3.827
+G1 X57.513 Y3.974
+G1 X58.513 Y4.974 Z1.008 F600
+G1 X58.809 Y5.158
+G0 X63.996 Y1.438 F3000
+G0 X81.481 Y12.737 F3000
+G0 X94.094 Y16.956 F12000
+G1 X95.094 Y17.956 Z2.395 F6000
+G2 X95.094 Y17.956 I0.442 J-3.479
+G2 X95.094 Y17.956 I-0.155 J-0.329
+G1 X95.202 Y18.203
+G1 X95.187 Y18.397
+G1 X95.292 Y18.764
+G0 X91.369 Y26.321 F12000
+G1 X91.235 Y26.652
+G1 X90.995 Y26.951
+G1 X90.990 Y27.058
+G0 X77.732 Y33.180 F12000
+G1 X78.024 Y33.216
+G1 X78.111 Y33.172
+G0 X86.753 Y23.522 F3000
+G2 X86.753 Y23.522 I-4.695 J3.994
+G0 X79.414 Y20.793 F3000
+G0 X67.010 Y25.828 F3000
+G2 X67.010 Y25.828 I0.791 J0.814
+G1 X68.010 Y26.828 Z0.445 F6000
+G1 X67.840 Y27.095
+G2 X67.840 Y27.095 I-0.593 J-1.902
+G1 X67.633 Y27.019
+G0 X50.362 Y16.124 F12000
+G1 X50.142 Y16.036
+G1 X50.320 Y16.369
+G1 X50.048 Y16.592
+G2 X50.048 Y16.592 I4.641 J1.132
+G1 X50.418 Y16.462
+G0 X34.227 Y12.451 F12000
+G1 X34.528 Y12.835
+G1 X34.455 Y12.963
+G1 X34.516 Y12.918
+G1 X34.305 Y12.846
+G1 X34.017 Y12.649
+G1 X34.428 Y12.958
+G1 X34.285 Y12.854
+G2 X34.285 Y12.854 I1.460 J2.937
+G1 X34.295 Y13.180
+G1 X34.446 Y13.132
+G1 X34.668 Y13.114
+G1 X34.798 Y13.229
+G1 X35.244 Y13.498
+G1 X35.096 Y13.598
+G1 X35.020 Y13.888
+G1 X35.078 Y13.886
+G1 X34.986 Y14.067
+G1 X35.156 Y14.340
+G1 X35.199 Y14.559
+G0 X53.965 Y30.761 F12000
+G1 X54.234 Y30.882
+G1 X55.234 Y31.882 Z0.210 F6000
+G0 X64.079 Y41.971 F12000
+G1 X63.856 Y41.806
+G1 X63.898 Y41.633
+G0 X80.392 Y42.146 F12000
+G1 X80.343 Y42.022
+G1 X80.574 Y42.360
+G0 X96.524 Y40.203 F12000
+G1 X96.865 Y40.054
+G1 X96.872 Y40.294
+G1 X96.676 Y40.571
+G2 X96.676 Y40.571 I3.559 J-1.963
+G1 X96.572 Y40.705
+G1 X96.543 Y40.975
+G1 X97.543 Y41.975 Z1.752 F600
+G1 X97.895 Y42.090
+G1 X98.270 Y42.238
+G1 X97.995 Y42.626
+G1 X98.995 Y43.626 Z2.230 F600
+G1 X99.111 Y43.485
+G1 X99.271 Y43.311
+G2 X99.271 Y43.311 I1.511 J-1.863
+G1 X99.253 Y43.306
+G0 X99.296 Y44.351 F3000
+G1 X99.577 Y44.622
+G1 X99.639 Y44.590
+G1 X99.630 Y44.835
+G1 X100.042 Y44.682
+G1 X99.786 Y44.511
+G1 X100.169 Y44.462
+G1 X100.328 Y44.465
+G1 X101.328 Y45.465 Z2.391 F6000
+G1 X101.400 Y45.853
+G1 X101.234 Y45.742
+G0 X103.745 Y62.014 F3000
+G0 X121.313 Y66.802 F3000
+G1 X122.313 Y67.802 Z2.044 F600
+G1 X122.066 Y67.945
+G0 X136.272 Y79.714 F3000
+G0 X123.207 Y94.187 F3000
+G1 X123.627 Y94.279
+G2 X123.627 Y94.279 I-2.801 J-2.996
+G1 X124.046 Y94.220
+G1 X124.040 Y94.568
+G1 X124.125 Y94.411
+G2 X124.125 Y94.411 I4.763 J-0.927
+G1 X124.251 Y94.440
+G2 X124.251 Y94.440 I-4.236 J1.158
+G1 X124.414 Y94.495
+G1 X124.904 Y94.299
+G1 X125.904 Y95.299 Z2.088 F600
+G1 X126.261 Y95.406
+G1 X127.261 Y96.406 Z0.947 F6000
+G1 X127.395 Y96.698
+G1 X128.395 Y97.698 Z1.225 F6000
+G1 X128.200 Y97.764
+G1 X128.518 Y98.149
+G1 X128.226 Y98.203
+G0 X109.676 Y95.038 F12000
+G1 X110.676 Y96.038 Z2.686 F600
+G2 X110.676 Y96.038 I4.252 J3.463
+G1 X110.747 Y96.316
+G1 X111.046 Y96.404
+G1 X111.111 Y96.274
+G1 X111.144 Y96.085
+G1 X111.052 Y96.400
+G1 X110.981 Y96.799
+G1 X111.092 Y97.042
+G0 X108.433 Y108.122 F12000
+G1 X108.796 Y108.492
+G1 X108.836 Y108.331
+G1 X108.656 Y108.569
+G1 X108.481 Y108.833
+G1 X108.700 Y108.746
+G1 X108.743 Y109.119
+G1 X108.617 Y109.172
+G1 X108.838 Y109.528
+G0 X116.001 Y122.924 F3000
+G1 X117.001 Y123.924 Z2.054 F600
+G1 X117.336 Y124.239
+G0 X124.408 Y107.726 F12000
+G1 X124.466 Y107.936
+G1 X124.480 Y108.099
+G1 X124.300 Y108.267
+G0 X110.985 Y98.572 F12000
+G2 X110.985 Y98.572 I1.337 J3.102
+G1 X111.985 Y99.572 Z2.366 F6000
+G2 X111.985 Y99.572 I-3.971 J2.578
+G0 X105.860 Y114.978 F12000
+G1 X106.060 Y114.958
+G1 X107.060 Y115.958 Z0.302 F6000
+G1 X106.957 Y115.847
+G1 X106.983 Y116.025
+G1 X107.983 Y117.025 Z0.175 F600
+G1 X108.983 Y118.025 Z0.810 F6000
+G0 X99.666 Y106.601 F12000
+G1 X99.559 Y106.507
+G0 X109.127 Y109.729 F12000
+G1 X108.874 Y109.724
+G0 X114.676 Y122.202 F3000
+G1 X114.771 Y122.200
+G1 X114.583 Y122.154
+G1 X114.714 Y122.376
+G1 X114.962 Y122.312
+G1 X115.116 Y122.642
+G1 X114.820 Y122.454
+G1 X115.012 Y122.305
+G1 X115.257 Y122.696
+G1 X115.438 Y122.807
+G1 X115.401 Y122.691
+G1 X115.717 Y122.900
+G1 X115.479 Y123.135
+G1 X115.433 Y123.096
+G1 X115.158 Y122.980
+G1 X115.605 Y123.163
+G1 X115.848 Y123.127
+G1 X115.806 Y123.496
+G1 X116.149 Y123.681
+G2 X116.149 Y123.681 I1.062 J3.704
+G1 X116.392 Y123.853
+G1 X116.544 Y123.975
+G1 X116.962 Y124.154
+G1 X116.705 Y124.259
+G1 X116.577 Y124.320
+G1 X116.478 Y124.283
+G1 X116.556 Y124.325
+G1 X116.555 Y124.517
+G1 X116.691 Y124.824
+G0 X124.074 Y106.040 F12000
+G1 X123.880 Y105.885
+G1 X124.122 Y106.181
+G1 X124.462 Y106.441
+G1 X124.396 Y106.335
+G0 X137.721 Y102.560 F3000
+G1 X137.955 Y102.840
+G0 X118.282 Y120.933 F3000
+G1 X118.432 Y121.263
+G1 X118.755 Y121.422
+G1 X119.202 Y121.467
+G0 X101.333 Y120.298 F3000
+G0 X109.228 Y132.785 F3000
+G1 X109.352 Y133.043
+G1 X109.678 Y133.184
+G1 X110.678 Y134.184 Z1.069 F6000
+G2 X110.678 Y134.184 I-2.548 J3.083
+G1 X110.828 Y134.199
+G1 X111.150 Y134.549
+G1 X111.553 Y134.556
+G0 X131.385 Y145.439 F3000
+G0 X127.982 Y139.789 F12000
+G1 X128.242 Y139.970
+G1 X127.987 Y140.174
+G2 X127.987 Y140.174 I-3.278 J1.427
+G1 X127.959 Y140.400
+G1 X128.959 Y141.400 Z0.065 F600
+G1 X129.327 Y141.305
+G0 X113.314 Y134.729 F12000
+G0 X124.695 Y133.181 F12000
+G1 X124.916 Y133.379
+G1 X125.916 Y134.379 Z1.296 F6000
+G1 X126.074 Y134.735
+G2 X126.074 Y134.735 I-3.501 J-1.239
+G1 X125.795 Y134.580
+G1 X126.107 Y134.780
+G0 X117.648 Y121.001 F3000
+G1 X118.648 Y122.001 Z0.056 F6000
+G2 X118.648 Y122.001 I2.047 J2.929
+G1 X118.904 Y122.396
+G1 X118.804 Y122.450
+G1 X118.647 Y122.647
+G1 X118.776 Y122.782
+G1 X118.776 Y122.595
+G1 X118.665 Y122.419
+G1 X118.517 Y122.521
+G0 X138.446 Y105.610 F12000
+G0 X123.209 Y111.366 F12000
+G1 X122.985 Y111.655
+M400
@@ -0,0 +1,405 @@
+G21
+G90
+G1 X0 Y0 F6000
+G1 X1 Y0.00
+G1 X2 Y0.01
+G1 X3 Y0.00
+G1 X4 Y0.01
+G1 X5 Y0.00
+G1 X6 Y0.01
+G1 X7 Y0.00
+G1 X8 Y0.01
+G1 X9 Y0.00
+G1 X10 Y0.01
+G1 X11 Y0.00
+G1 X12 Y0.01
+G1 X13 Y0.00
+G1 X14 Y0.01
+G1 X15 Y0.00
+G1 X16 Y0.01
+G1 X17 Y0.00
+G1 X18 Y0.01
+G1 X19 Y0.00
+G1 X20 Y0.01
+G1 X21 Y0.00
+G1 X22 Y0.01
+G1 X23 Y0.00
+G1 X24 Y0.01
+G1 X25 Y0.00
+G1 X26 Y0.01
+G1 X27 Y0.00
+G1 X28 Y0.01
+G1 X29 Y0.00
+G1 X30 Y0.01
+G1 X31 Y0.00
+G1 X32 Y0.01
+G1 X33 Y0.00
+G1 X34 Y0.01
+G1 X35 Y0.00
+G1 X36 Y0.01
+G1 X37 Y0.00
+G1 X38 Y0.01
+G1 X39 Y0.00
+G1 X40 Y0.01
+G1 X41 Y0.00
+G1 X42 Y0.01
+G1 X43 Y0.00
+G1 X44 Y0.01
+G1 X45 Y0.00
+G1 X46 Y0.01
+G1 X47 Y0.00
+G1 X48 Y0.01
+G1 X49 Y0.00
+G1 X50 Y0.01
+G1 X51 Y0.00
+G1 X52 Y0.01
+G1 X53 Y0.00
+G1 X54 Y0.01
+G1 X55 Y0.00
+G1 X56 Y0.01
+G1 X57 Y0.00
+G1 X58 Y0.01
+G1 X59 Y0.00
+G1 X60 Y0.01
+G1 X61 Y0.00
+G1 X62 Y0.01
+G1 X63 Y0.00
+G1 X64 Y0.01
+G1 X65 Y0.00
+G1 X66 Y0.01
+G1 X67 Y0.00
+G1 X68 Y0.01
+G1 X69 Y0.00
+G1 X70 Y0.01
+G1 X71 Y0.00
+G1 X72 Y0.01
+G1 X73 Y0.00
+G1 X74 Y0.01
+G1 X75 Y0.00
+G1 X76 Y0.01
+G1 X77 Y0.00
+G1 X78 Y0.01
+G1 X79 Y0.00
+G1 X80 Y0.01
+G1 X81 Y0.00
+G1 X82 Y0.01
+G1 X83 Y0.00
+G1 X84 Y0.01
+G1 X85 Y0.00
+G1 X86 Y0.01
+G1 X87 Y0.00
+G1 X88 Y0.01
+G1 X89 Y0.00
+G1 X90 Y0.01
+G1 X91 Y0.00
+G1 X92 Y0.01
+G1 X93 Y0.00
+G1 X94 Y0.01
+G1 X95 Y0.00
+G1 X96 Y0.01
+G1 X97 Y0.00
+G1 X98 Y0.01
+G1 X99 Y0.00
+G1 X100 Y0.01
+G1 X101 Y0.00
+G1 X102 Y0.01
+G1 X103 Y0.00
+G1 X104 Y0.01
+G1 X105 Y0.00
+G1 X106 Y0.01
+G1 X107 Y0.00
+G1 X108 Y0.01
+G1 X109 Y0.00
+G1 X110 Y0.01
+G1 X111 Y0.00
+G1 X112 Y0.01
+G1 X113 Y0.00
+G1 X114 Y0.01
+G1 X115 Y0.00
+G1 X116 Y0.01
+G1 X117 Y0.00
+G1 X118 Y0.01
+G1 X119 Y0.00
+G1 X120 Y0.01
+G1 X121 Y0.00
+G1 X122 Y0.01
+G1 X123 Y0.00
+G1 X124 Y0.01
+G1 X125 Y0.00
+G1 X126 Y0.01
+G1 X127 Y0.00
+G1 X128 Y0.01
+G1 X129 Y0.00
+G1 X130 Y0.01
+G1 X131 Y0.00
+G1 X132 Y0.01
+G1 X133 Y0.00
+G1 X134 Y0.01
+G1 X135 Y0.00
+G1 X136 Y0.01
+G1 X137 Y0.00
+G1 X138 Y0.01
+G1 X139 Y0.00
+G1 X140 Y0.01
+G1 X141 Y0.00
+G1 X142 Y0.01
+G1 X143 Y0.00
+G1 X144 Y0.01
+G1 X145 Y0.00
+G1 X146 Y0.01
+G1 X147 Y0.00
+G1 X148 Y0.01
+G1 X149 Y0.00
+G1 X150 Y0.01
+M220 S50
+G1 X151 Y0.00
+G1 X152 Y0.01
+G1 X153 Y0.00
+G1 X154 Y0.01
+G1 X155 Y0.00
+G1 X156 Y0.01
+G1 X157 Y0.00
+G1 X158 Y0.01
+G1 X159 Y0.00
+G1 X160 Y0.01
+G1 X161 Y0.00
+G1 X162 Y0.01
+G1 X163 Y0.00
+G1 X164 Y0.01
+G1 X165 Y0.00
+G1 X166 Y0.01
+G1 X167 Y0.00
+G1 X168 Y0.01
+G1 X169 Y0.00
+G1 X170 Y0.01
+G1 X171 Y0.00
+G1 X172 Y0.01
+G1 X173 Y0.00
+G1 X174 Y0.01
+G1 X175 Y0.00
+G1 X176 Y0.01
+G1 X177 Y0.00
+G1 X178 Y0.01
+G1 X179 Y0.00
+G1 X180 Y0.01
+G1 X181 Y0.00
+G1 X182 Y0.01
+G1 X183 Y0.00
+G1 X184 Y0.01
+G1 X185 Y0.00
+G1 X186 Y0.01
+G1 X187 Y0.00
+G1 X188 Y0.01
+G1 X189 Y0.00
+G1 X190 Y0.01
+G1 X191 Y0.00
+G1 X192 Y0.01
+G1 X193 Y0.00
+G1 X194 Y0.01
+G1 X195 Y0.00
+G1 X196 Y0.01
+G1 X197 Y0.00
+G1 X198 Y0.01
+G1 X199 Y0.00
+G1 X200 Y0.01
+G1 X201 Y0.00
+G1 X202 Y0.01
+G1 X203 Y0.00
+G1 X204 Y0.01
+G1 X205 Y0.00
+G1 X206 Y0.01
+G1 X207 Y0.00
+G1 X208 Y0.01
+G1 X209 Y0.00
+G1 X210 Y0.01
+G1 X211 Y0.00
+G1 X212 Y0.01
+G1 X213 Y0.00
+G1 X214 Y0.01
+G1 X215 Y0.00
+G1 X216 Y0.01
+G1 X217 Y0.00
+G1 X218 Y0.01
+G1 X219 Y0.00
+G1 X220 Y0.01
+G1 X221 Y0.00
+G1 X222 Y0.01
+G1 X223 Y0.00
+G1 X224 Y0.01
+G1 X225 Y0.00
+G1 X226 Y0.01
+G1 X227 Y0.00
+G1 X228 Y0.01
+G1 X229 Y0.00
+G1 X230 Y0.01
+G1 X231 Y0.00
+G1 X232 Y0.01
+G1 X233 Y0.00
+G1 X234 Y0.01
+G1 X235 Y0.00
+G1 X236 Y0.01
+G1 X237 Y0.00
+G1 X238 Y0.01
+G1 X239 Y0.00
+G1 X240 Y0.01
+G1 X241 Y0.00
+G1 X242 Y0.01
+G1 X243 Y0.00
+G1 X244 Y0.01
+G1 X245 Y0.00
+G1 X246 Y0.01
+G1 X247 Y0.00
+G1 X248 Y0.01
+G1 X249 Y0.00
+G1 X250 Y0.01
+G1 X251 Y0.00
+G1 X252 Y0.01
+G1 X253 Y0.00
+G1 X254 Y0.01
+G1 X255 Y0.00
+G1 X256 Y0.01
+G1 X257 Y0.00
+G1 X258 Y0.01
+G1 X259 Y0.00
+G1 X260 Y0.01
+G1 X261 Y0.00
+G1 X262 Y0.01
+G1 X263 Y0.00
+G1 X264 Y0.01
+G1 X265 Y0.00
+G1 X266 Y0.01
+G1 X267 Y0.00
+G1 X268 Y0.01
+G1 X269 Y0.00
+G1 X270 Y0.01
+G1 X271 Y0.00
+G1 X272 Y0.01
+G1 X273 Y0.00
+G1 X274 Y0.01
+G1 X275 Y0.00
+G1 X276 Y0.01
+G1 X277 Y0.00
+G1 X278 Y0.01
+G1 X279 Y0.00
+G1 X280 Y0.01
+G1 X281 Y0.00
+G1 X282 Y0.01
+G1 X283 Y0.00
+G1 X284 Y0.01
+G1 X285 Y0.00
+G1 X286 Y0.01
+G1 X287 Y0.00
+G1 X288 Y0.01
+G1 X289 Y0.00
+G1 X290 Y0.01
+G1 X291 Y0.00
+G1 X292 Y0.01
+G1 X293 Y0.00
+G1 X294 Y0.01
+G1 X295 Y0.00
+G1 X296 Y0.01
+G1 X297 Y0.00
+G1 X298 Y0.01
+G1 X299 Y0.00
+G1 X300 Y0.01
+M220 S200
+G1 X301 Y0.00
+G1 X302 Y0.01
+G1 X303 Y0.00
+G1 X304 Y0.01
+G1 X305 Y0.00
+G1 X306 Y0.01
+G1 X307 Y0.00
+G1 X308 Y0.01
+G1 X309 Y0.00
+G1 X310 Y0.01
+G1 X311 Y0.00
+G1 X312 Y0.01
+G1 X313 Y0.00
+G1 X314 Y0.01
+G1 X315 Y0.00
+G1 X316 Y0.01
+G1 X317 Y0.00
+G1 X318 Y0.01
+G1 X319 Y0.00
+G1 X320 Y0.01
+G1 X321 Y0.00
+G1 X322 Y0.01
+G1 X323 Y0.00
+G1 X324 Y0.01
+G1 X325 Y0.00
+G1 X326 Y0.01
+G1 X327 Y0.00
+G1 X328 Y0.01
+G1 X329 Y0.00
+G1 X330 Y0.01
+G1 X331 Y0.00
+G1 X332 Y0.01
+G1 X333 Y0.00
+G1 X334 Y0.01
+G1 X335 Y0.00
+G1 X336 Y0.01
+G1 X337 Y0.00
+G1 X338 Y0.01
+G1 X339 Y0.00
+G1 X340 Y0.01
+G1 X341 Y0.00
+G1 X342 Y0.01
+G1 X343 Y0.00
+G1 X344 Y0.01
+G1 X345 Y0.00
+G1 X346 Y0.01
+G1 X347 Y0.00
+G1 X348 Y0.01
+G1 X349 Y0.00
+G1 X350 Y0.01
+G1 X351 Y0.00
+G1 X352 Y0.01
+G1 X353 Y0.00
+G1 X354 Y0.01
+G1 X355 Y0.00
+G1 X356 Y0.01
+G1 X357 Y0.00
+G1 X358 Y0.01
+G1 X359 Y0.00
+G1 X360 Y0.01
+G1 X361 Y0.00
+G1 X362 Y0.01
+G1 X363 Y0.00
+G1 X364 Y0.01
+G1 X365 Y0.00
+G1 X366 Y0.01
+G1 X367 Y0.00
+G1 X368 Y0.01
+G1 X369 Y0.00
+G1 X370 Y0.01
+G1 X371 Y0.00
+G1 X372 Y0.01
+G1 X373 Y0.00
+G1 X374 Y0.01
+G1 X375 Y0.00
+G1 X376 Y0.01
+G1 X377 Y0.00
+G1 X378 Y0.01
+G1 X379 Y0.00
+G1 X380 Y0.01
+G1 X381 Y0.00
+G1 X382 Y0.01
+G1 X383 Y0.00
+G1 X384 Y0.01
+G1 X385 Y0.00
+G1 X386 Y0.01
+G1 X387 Y0.00
+G1 X388 Y0.01
+G1 X389 Y0.00
+G1 X390 Y0.01
+G1 X391 Y0.00
+G1 X392 Y0.01
+G1 X393 Y0.00
+G1 X394 Y0.01
+G1 X395 Y0.00
+G1 X396 Y0.01
+G1 X397 Y0.00
+G1 X398 Y0.01
+G1 X399 Y0.00
+G1 X400 Y0.01
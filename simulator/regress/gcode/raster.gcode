@@ -0,0 +1,8 @@
+; raster lines, each pixel scales S along the move
+G21
+G90
+G1 X1 F6000
+G1 X2 S1 D00407fbfff
+G1 X14 S1 D00050a0f14191e23282d32373c41464b50555a5f64696e73787d82878c91969ba0a5aaafb4b9bec3c8cdd2d7dce1e6eb
+G1 X3
+M400
@@ -0,0 +1,8 @@
+; three short segments that end at a standstill, an S-curve or shaped ramp used to leave the last step crawling
+G21
+G90
+G92 X10 Y10
+G1 X9.762 Y10.235 F6000
+G1 X9.716 Y10.196
+G1 X9.441 Y10.08
+M400
@@ -0,0 +1,401 @@
+G21 G90 G1 F6000
+G1 X70.000 Y50.000
+G1 X68.297 Y62.884
+G1 X53.399 Y69.709
+G1 X42.903 Y67.264
+G1 X31.156 Y56.700
+G1 X34.271 Y42.984
+G1 X40.195 Y32.568
+G1 X56.730 Y30.351
+G1 X65.511 Y37.375
+G1 X72.997 Y50.336
+G1 X65.078 Y63.140
+G1 X56.067 Y69.763
+G1 X39.614 Y67.092
+G1 X34.046 Y56.382
+G1 X31.391 Y42.670
+G1 X43.489 Y32.406
+G1 X54.060 Y30.416
+G1 X68.721 Y37.637
+G1 X69.989 Y50.672
+G1 X67.855 Y63.391
+G1 X52.735 Y69.812
+G1 X42.328 Y66.915
+G1 X30.941 Y56.062
+G1 X34.517 Y42.359
+G1 X40.786 Y32.249
+G1 X57.389 Y30.487
+G1 X65.927 Y37.903
+G1 X72.975 Y51.008
+G1 X64.628 Y63.639
+G1 X55.401 Y69.855
+G1 X39.045 Y66.733
+G1 X33.842 Y55.741
+G1 X31.648 Y42.049
+G1 X44.086 Y32.096
+G1 X54.716 Y30.564
+G1 X69.128 Y38.173
+G1 X69.955 Y51.344
+G1 X67.396 Y63.883
+G1 X52.067 Y69.893
+G1 X41.766 Y66.547
+G1 X30.748 Y55.418
+G1 X34.785 Y41.741
+G1 X41.388 Y31.949
+G1 X58.042 Y30.646
+G1 X66.325 Y38.446
+G1 X72.929 Y51.679
+G1 X64.161 Y64.123
+G1 X54.732 Y69.925
+G1 X38.489 Y66.355
+G1 X33.660 Y55.094
+G1 X31.926 Y41.436
+G1 X44.693 Y31.807
+G1 X55.367 Y30.734
+G1 X69.517 Y38.722
+G1 X69.898 Y52.014
+G1 X66.921 Y64.359
+G1 X51.397 Y69.951
+G1 X41.216 Y66.159
+G1 X30.577 Y54.768
+G1 X35.073 Y41.134
+G1 X42.000 Y31.670
+G1 X58.690 Y30.827
+G1 X66.704 Y39.001
+G1 X72.862 Y52.349
+G1 X63.678 Y64.592
+G1 X54.061 Y69.972
+G1 X37.946 Y65.959
+G1 X33.499 Y54.440
+G1 X32.224 Y40.833
+G1 X45.310 Y31.538
+G1 X56.012 Y30.925
+G1 X69.887 Y39.284
+G1 X69.819 Y52.682
+G1 X66.431 Y64.819
+G1 X50.725 Y69.987
+G1 X40.679 Y65.754
+G1 X30.427 Y54.112
+G1 X35.381 Y40.536
+G1 X42.621 Y31.411
+G1 X59.332 Y31.029
+G1 X67.064 Y39.569
+G1 X72.771 Y53.015
+G1 X63.180 Y65.043
+G1 X53.389 Y69.996
+G1 X37.416 Y65.545
+G1 X33.361 Y53.782
+G1 X32.543 Y40.241
+G1 X45.935 Y31.290
+G1 X56.650 Y31.138
+G1 X70.237 Y39.857
+G1 X69.718 Y53.347
+G1 X65.925 Y65.263
+G1 X50.053 Y70.000
+G1 X40.156 Y65.331
+G1 X30.300 Y53.452
+G1 X35.709 Y39.949
+G1 X43.250 Y31.173
+G1 X59.966 Y31.252
+G1 X67.405 Y40.149
+G1 X72.659 Y53.678
+G1 X62.666 Y65.478
+G1 X52.717 Y69.998
+G1 X36.900 Y65.113
+G1 X33.245 Y53.120
+G1 X32.881 Y39.660
+G1 X46.568 Y31.063
+G1 X57.280 Y31.372
+G1 X70.569 Y40.443
+G1 X69.594 Y54.008
+G1 X65.404 Y65.689
+G1 X49.380 Y69.990
+G1 X39.648 Y64.890
+G1 X30.195 Y52.787
+G1 X36.057 Y39.373
+G1 X43.887 Y30.957
+G1 X60.592 Y31.497
+G1 X67.727 Y40.739
+G1 X72.524 Y54.337
+G1 X62.139 Y65.895
+G1 X52.044 Y69.977
+G1 X36.400 Y64.664
+G1 X33.151 Y52.454
+G1 X33.238 Y39.090
+G1 X47.208 Y30.857
+G1 X57.902 Y31.627
+G1 X70.880 Y41.039
+G1 X69.448 Y54.665
+G1 X64.870 Y66.097
+G1 X48.709 Y69.958
+G1 X39.155 Y64.433
+G1 X30.113 Y52.120
+G1 X36.424 Y38.809
+G1 X44.531 Y30.762
+G1 X61.210 Y31.763
+G1 X68.028 Y41.341
+G1 X72.367 Y54.991
+G1 X61.598 Y66.294
+G1 X51.373 Y69.934
+G1 X35.914 Y64.198
+G1 X33.080 Y51.785
+G1 X33.614 Y38.532
+G1 X47.855 Y30.673
+G1 X58.516 Y31.904
+G1 X71.171 Y41.645
+G1 X69.281 Y55.316
+G1 X64.322 Y66.487
+G1 X48.038 Y69.904
+G1 X38.677 Y63.959
+G1 X30.053 Y51.450
+G1 X36.809 Y38.258
+G1 X45.181 Y30.589
+G1 X61.819 Y32.049
+G1 X68.309 Y41.952
+G1 X72.188 Y55.639
+G1 X61.043 Y66.675
+G1 X50.704 Y69.868
+G1 X35.445 Y63.717
+G1 X33.031 Y51.114
+G1 X34.009 Y37.988
+G1 X48.508 Y30.511
+G1 X59.119 Y32.200
+G1 X71.442 Y42.261
+G1 X69.091 Y55.961
+G1 X63.761 Y66.858
+G1 X47.370 Y69.826
+G1 X38.216 Y63.470
+G1 X30.015 Y50.778
+G1 X37.213 Y37.721
+G1 X45.836 Y30.438
+G1 X62.417 Y32.356
+G1 X68.569 Y42.572
+G1 X71.988 Y56.281
+G1 X60.476 Y67.037
+G1 X50.037 Y69.779
+G1 X34.992 Y63.219
+G1 X33.005 Y50.442
+G1 X34.422 Y37.457
+G1 X49.166 Y30.371
+G1 X59.713 Y32.517
+G1 X71.692 Y42.885
+G1 X68.880 Y56.600
+G1 X63.188 Y67.210
+G1 X46.705 Y69.727
+G1 X37.772 Y62.965
+G1 X30.000 Y50.106
+G1 X37.635 Y37.197
+G1 X46.496 Y30.309
+G1 X63.005 Y32.683
+G1 X68.809 Y43.200
+G1 X71.766 Y56.916
+G1 X59.897 Y67.379
+G1 X49.374 Y69.669
+G1 X34.556 Y62.707
+G1 X33.001 Y49.770
+G1 X34.853 Y36.940
+G1 X49.828 Y30.253
+G1 X60.295 Y32.853
+G1 X71.920 Y43.518
+G1 X68.647 Y57.231
+G1 X62.604 Y67.543
+G1 X46.044 Y69.605
+G1 X37.344 Y62.446
+G1 X30.008 Y49.433
+G1 X38.074 Y36.688
+G1 X47.160 Y30.203
+G1 X63.582 Y33.029
+G1 X69.027 Y43.837
+G1 X71.523 Y57.543
+G1 X59.308 Y67.702
+G1 X48.715 Y69.536
+G1 X34.137 Y62.181
+G1 X33.020 Y49.097
+G1 X35.300 Y36.438
+G1 X50.494 Y30.158
+G1 X60.866 Y33.209
+G1 X72.128 Y44.158
+G1 X68.393 Y57.854
+G1 X62.009 Y67.856
+G1 X45.387 Y69.461
+G1 X36.935 Y61.912
+G1 X30.038 Y48.762
+G1 X38.530 Y36.193
+G1 X47.828 Y30.118
+G1 X64.147 Y33.394
+G1 X69.223 Y44.480
+G1 X71.259 Y58.162
+G1 X58.707 Y68.005
+G1 X48.060 Y69.380
+G1 X33.737 Y61.641
+G1 X33.062 Y48.426
+G1 X35.765 Y35.952
+G1 X51.162 Y30.085
+G1 X61.424 Y33.584
+G1 X72.313 Y44.804
+G1 X68.119 Y58.468
+G1 X61.403 Y68.149
+G1 X44.735 Y69.295
+G1 X36.543 Y61.366
+G1 X30.091 Y48.091
+G1 X39.003 Y35.714
+G1 X48.497 Y30.057
+G1 X64.699 Y33.778
+G1 X69.398 Y45.129
+G1 X70.974 Y58.771
+G1 X58.097 Y68.288
+G1 X47.411 Y69.203
+G1 X33.354 Y61.087
+G1 X33.126 Y47.757
+G1 X36.245 Y35.481
+G1 X51.833 Y30.034
+G1 X61.970 Y33.977
+G1 X72.477 Y45.456
+G1 X67.824 Y59.072
+G1 X60.788 Y68.421
+G1 X44.089 Y69.107
+G1 X36.170 Y60.806
+G1 X30.167 Y47.423
+G1 X39.491 Y35.252
+G1 X49.169 Y30.017
+G1 X65.237 Y34.181
+G1 X69.551 Y45.784
+G1 X70.669 Y59.371
+G1 X57.477 Y68.550
+G1 X46.769 Y69.005
+G1 X32.991 Y60.521
+G1 X33.213 Y47.090
+G1 X36.741 Y35.027
+G1 X52.505 Y30.006
+G1 X62.502 Y34.389
+G1 X72.619 Y46.114
+G1 X67.509 Y59.666
+G1 X60.164 Y68.673
+G1 X43.450 Y68.897
+G1 X35.817 Y60.234
+G1 X30.265 Y46.757
+G1 X39.994 Y34.806
+G1 X49.841 Y30.001
+G1 X65.762 Y34.601
+G1 X69.681 Y46.444
+G1 X70.344 Y59.959
+G1 X56.849 Y68.791
+G1 X46.133 Y68.784
+G1 X32.647 Y59.943
+G1 X33.322 Y46.426
+G1 X37.252 Y34.590
+G1 X53.177 Y30.001
+G1 X63.019 Y34.818
+G1 X72.738 Y46.776
+G1 X67.174 Y60.250
+G1 X59.532 Y68.903
+G1 X42.819 Y68.666
+G1 X35.482 Y59.650
+G1 X30.385 Y46.096
+G1 X40.513 Y34.377
+G1 X50.514 Y30.007
+G1 X66.273 Y35.039
+G1 X69.790 Y47.108
+G1 X69.999 Y60.537
+G1 X56.214 Y69.010
+G1 X45.506 Y68.543
+G1 X32.322 Y59.354
+G1 X33.453 Y45.766
+G1 X37.777 Y34.170
+G1 X53.850 Y30.018
+G1 X63.523 Y35.264
+G1 X72.836 Y47.441
+G1 X66.820 Y60.821
+G1 X58.893 Y69.112
+G1 X42.195 Y68.414
+G1 X35.168 Y59.056
+G1 X30.527 Y45.438
+G1 X41.045 Y33.966
+G1 X51.186 Y30.035
+G1 X66.768 Y35.494
+G1 X69.876 Y47.775
+G1 X69.635 Y61.103
+G1 X55.571 Y69.208
+G1 X44.886 Y68.280
+G1 X32.018 Y58.755
+G1 X33.607 Y45.112
+G1 X38.316 Y33.768
+G1 X54.521 Y30.058
+G1 X64.010 Y35.727
+G1 X72.910 Y48.109
+G1 X66.446 Y61.381
+G1 X58.247 Y69.299
+G1 X41.580 Y68.141
+G1 X34.873 Y58.451
+G1 X30.692 Y44.786
+G1 X41.591 Y33.573
+G1 X51.856 Y30.086
+G1 X67.248 Y35.965
+G1 X69.939 Y48.444
+G1 X69.253 Y61.656
+G1 X54.922 Y69.385
+G1 X44.276 Y67.997
+G1 X31.734 Y58.145
+G1 X33.782 Y44.462
+G1 X38.869 Y33.384
+G1 X55.191 Y30.120
+G1 X64.482 Y36.206
+G1 X72.963 Y48.780
+G1 X66.054 Y61.927
+G1 X57.595 Y69.465
+G1 X40.975 Y67.848
+G1 X34.599 Y57.837
+G1 X30.878 Y44.140
+G1 X42.150 Y33.199
+G1 X52.525 Y30.160
+G1 X67.712 Y36.452
+G1 X69.980 Y49.116
+G1 X68.852 Y62.195
+G1 X54.267 Y69.539
+G1 X43.676 Y67.694
+G1 X31.470 Y57.526
+G1 X33.979 Y43.819
+G1 X39.434 Y33.019
+G1 X55.858 Y30.205
+G1 X64.938 Y36.701
+G1 X72.992 Y49.452
+G1 X65.644 Y62.460
+G1 X56.938 Y69.608
+G1 X40.380 Y67.534
+G1 X34.346 Y57.214
+G1 X31.086 Y43.500
+G1 X42.721 Y32.844
+G1 X53.190 Y30.256
+G1 X68.159 Y36.954
+G1 X69.999 Y49.788
+G1 X68.433 Y62.722
+G1 X53.608 Y69.672
+G1 X43.087 Y67.370
+G1 X31.228 Y56.899
+G1 X34.198 Y43.183
+G1 X40.011 Y32.673
+G1 X56.522 Y30.313
+G1 X65.377 Y37.211
+G1 X73.000 Y50.124
+G1 X65.216 Y62.979
+G1 X56.277 Y69.730
+G1 X39.796 Y67.201
+G1 X34.114 Y56.582
+G1 X31.315 Y42.868
+G1 X43.303 Y32.508
+G1 X53.852 Y30.375
+G1 X68.590 Y37.471
+G1 X69.995 Y50.461
+G1 X67.996 Y63.233
+G1 X52.945 Y69.782
+G1 X42.508 Y67.027
+G1 X31.006 Y56.264
+G1 X34.437 Y42.555
+G1 X40.599 Y32.347
+G1 X57.182 Y30.442
+G1 X65.798 Y37.735
+G1 X72.984 Y50.797
+G1 X64.771 Y63.483
+G1 X55.612 Y69.829
+G1 X39.223 Y66.848
+G1 X33.904 Y55.944
@@ -0,0 +1,101 @@
+#!/bin/bash
+# Runs the simulator regression cases listed in cases, see the simulator Readme.md
+#
+# Usage: run.sh [-u] [-r reference_smoothiesim] [case name ...]   with no names all the cases are run
+#   -u  write the expected results from this run instead of checking them
+#   -r  also run each case with another build of the simulator (eg one built from the commit before a change)
+#       and compare the step timelines, the first step that is different is shown
+#
+# Each case is checked against expected/<name>.txt, the simulated time must be within 1% of it and the steps and
+# final position of every motor must be the same. Build the simulator first, exits non zero if any case fails
+
+DIR=$(cd "$(dirname "$0")" && pwd)
+SIM=${SIM:-$DIR/../smoothiesim}
+SAMPLES=$DIR/../../ConfigSamples
+TMP=$(mktemp -d)
+trap 'rm -rf "$TMP"' EXIT
+
+update=0
+ref=
+while getopts "ur:" opt; do
+    case $opt in
+        u) update=1 ;;
+        r) ref=$OPTARG ;;
+        *) sed -n '3,6p' "$0" >&2; exit 2 ;;
+    esac
+done
+shift $((OPTIND-1))
+
+for s in "$SIM" $ref; do
+    if [ ! -x "$s" ]; then
+        echo "$s not found, build the simulator first" >&2
+        exit 2
+    fi
+done
+
+# what is checked from the summary, the time and the steps and position of each motor
+results() {
+    sed -n -e 's/^simulated time: \([0-9.]*\) s.*/time \1/p' -e 's/^\(motor [0-9]*: steps [0-9]*, position [-0-9.]*\).*/\1/p' "$1"
+}
+
+failed=0
+while read -r name sample settings gcode; do
+    case "$name" in ""|\#*) continue ;; esac
+    if [ $# -gt 0 ] && [[ " $* " != *" $name "* ]]; then continue; fi
+
+    # the settings are added to the end of the sample config, a later line replaces an earlier one
+    cfg=$TMP/$name.cfg
+    cat "$SAMPLES/$sample/config" > "$cfg"
+    [ "$settings" != "-" ] && cat "$DIR/config/$settings" >> "$cfg"
+
+    if ! "$SIM" -q -c "$cfg" -o "$TMP/$name.csv" "$DIR/gcode/$gcode" 2> "$TMP/$name.txt" > /dev/null; then
+        echo "FAIL $name: the simulator failed"
+        failed=1
+        continue
+    fi
+    results "$TMP/$name.txt" > "$TMP/$name.got"
+
+    if [ $update -eq 1 ]; then
+        cp "$TMP/$name.got" "$DIR/expected/$name.txt"
+        echo "updated $name"
+        continue
+    fi
+
+    expected=$DIR/expected/$name.txt
+    if [ ! -f "$expected" ]; then
+        echo "FAIL $name: no expected results, run with -u to make them"
+        failed=1
+        continue
+    fi
+
+    t=$(sed -n 's/^time //p' "$TMP/$name.got")
+    e=$(sed -n 's/^time //p' "$expected")
+    if ! awk -v t="$t" -v e="$e" 'BEGIN { exit !(t != "" && t >= e * 0.99 && t <= e * 1.01) }'; then
+        echo "FAIL $name: took ${t:-?} s, expected $e s"
+        failed=1
+        continue
+    fi
+
+    if ! diff <(grep '^motor' "$expected") <(grep '^motor' "$TMP/$name.got") > "$TMP/$name.diff"; then
+        echo "FAIL $name: the motors did not end up where they should"
+        sed 's/^/    /' "$TMP/$name.diff"
+        failed=1
+        continue
+    fi
+
+    if [ -n "$ref" ]; then
+        "$ref" -q -c "$cfg" -o "$TMP/$name.ref.csv" "$DIR/gcode/$gcode" 2> /dev/null > /dev/null
+        if ! cmp -s "$TMP/$name.ref.csv" "$TMP/$name.csv"; then
+            # the timelines are time_us,motor,dir one line per step
+            n=$(cmp "$TMP/$name.ref.csv" "$TMP/$name.csv" 2>&1 | sed -n 's/.*line \([0-9]*\).*/\1/p')
+            echo "ok   $name ($t s) but the timeline is different from step $((${n:-2} - 1)): $(sed -n "${n:-2}p" "$TMP/$name.ref.csv") -> $(sed -n "${n:-2}p" "$TMP/$name.csv")"
+            continue
+        fi
+        echo "ok   $name ($t s) same timeline"
+        continue
+    fi
+
+    echo "ok   $name ($t s)"
+done < "$DIR/cases"
+
+exit $failed
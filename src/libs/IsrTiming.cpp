@@ -0,0 +1,99 @@
+/*
+      This file is part of Smoothie (http://smoothieware.org/). The motion control part is heavily based on Grbl (https://github.com/simen/grbl).
+      Smoothie is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+      Smoothie is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+      You should have received a copy of the GNU General Public License along with Smoothie. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "IsrTiming.h"
+#include "StreamOutput.h"
+#include "StepTicker.h"
+
+#include "system_LPC17xx.h" // mbed.h lib
+#include <string.h>
+
+IsrTiming::stats_t IsrTiming::duration[N_ISR];
+IsrTiming::stats_t IsrTiming::latency[N_ISR];
+uint32_t IsrTiming::overruns[N_ISR];
+uint32_t IsrTiming::due[N_ISR];
+volatile bool IsrTiming::enabled= false;
+
+void IsrTiming::enable(bool on)
+{
+    if(on && !enabled) {
+        // start the cycle counter
+        DEMCR |= 1 << 24; // TRCENA
+        DWT_CYCCNT = 0;
+        DWT_CTRL |= 1;    // CYCCNTENA
+        reset();
+    }
+    enabled= on;
+}
+
+void IsrTiming::reset()
+{
+    bool was= enabled;
+    enabled= false;
+    memset(duration, 0, sizeof(duration));
+    memset(latency, 0, sizeof(latency));
+    memset(overruns, 0, sizeof(overruns));
+    for (int i = 0; i < N_ISR; ++i) {
+        duration[i].min= UINT32_MAX;
+        latency[i].min= UINT32_MAX;
+        due[i]= now();
+    }
+    enabled= was;
+}
+
+void IsrTiming::add(stats_t& s, uint32_t cycles)
+{
+    ++s.count;
+    if(cycles < s.min) s.min= cycles;
+    if(cycles > s.max) s.max= cycles;
+    uint32_t b= cycles < 128 ? 0 : 31 - __builtin_clz(cycles) - 6;
+    ++s.histogram[b < n_buckets ? b : n_buckets - 1];
+}
+
+// called from the interrupt handlers, so keep it short
+void IsrTiming::record(uint8_t isr, uint32_t entry, uint32_t since_due)
+{
+    uint32_t d= now() - entry;
+    add(duration[isr], d);
+
+    // if it was due less time ago than it has been running it came due again before it finished
+    if(since_due < d) ++overruns[isr];
+    else add(latency[isr], since_due - d);
+}
+
+void IsrTiming::print_stats(StreamOutput *stream, const char *name, const stats_t& s)
+{
+    float us= SystemCoreClock / 1000000.0F;
+    if(s.count == 0) {
+        stream->printf("  %s: none\n", name);
+        return;
+    }
+    stream->printf("  %s: min %1.2fus max %1.2fus |", name, s.min / us, s.max / us);
+    for (int i = 0; i < n_buckets; ++i) {
+        if(s.histogram[i] == 0) continue;
+        if(i == n_buckets - 1) stream->printf(" >=%1.1fus %lu", (64 << i) / us, s.histogram[i]);
+        else stream->printf(" <%1.1fus %lu", (128 << i) / us, s.histogram[i]);
+    }
+    stream->printf("\n");
+}
+
+void IsrTiming::print(StreamOutput *stream)
+{
+    static const char *names[N_ISR]= {"step", "unstep", "pendsv", "slow ticker"};
+    if(!enabled) {
+        stream->printf("isr timing is off, turn it on with: isr on\n");
+        return;
+    }
+
+    // the step ISR has to finish well within a tick
+    stream->printf("step ticker period %1.2fus\n", 1000000.0F / StepTicker::getInstance()->get_frequency());
+    for (int i = 0; i < N_ISR; ++i) {
+        stream->printf("%s: %lu times, %lu overruns\n", names[i], duration[i].count, overruns[i]);
+        print_stats(stream, "duration", duration[i]);
+        print_stats(stream, "latency", latency[i]);
+    }
+}
@@ -0,0 +1,60 @@
+/*
+      This file is part of Smoothie (http://smoothieware.org/). The motion control part is heavily based on Grbl (https://github.com/simen/grbl).
+      Smoothie is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+      Smoothie is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+      You should have received a copy of the GNU General Public License along with Smoothie. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <stdint.h>
+
+#include "libs/LPC17xx/sLPC17xx.h"
+
+class StreamOutput;
+
+// the DWT cycle counter, these core debug registers are not in score_cm3.h
+#ifndef DWT_CYCCNT
+#define DWT_CTRL    (*(volatile uint32_t *)0xE0001000)
+#define DWT_CYCCNT  (*(volatile uint32_t *)0xE0001004)
+#define DEMCR       (*(volatile uint32_t *)0xE000EDFC)
+#endif
+
+// Times the motion interrupts with the DWT cycle counter. For each one how late it ran after it was due (latency)
+// and how long it ran for (duration) go into a min, a max and a histogram with power of two buckets.
+// It is off by default so it costs nothing, turn it on with the isr shell command.
+class IsrTiming {
+    public:
+        enum ISR { STEP, UNSTEP, PENDSV, SLOW_TICKER, N_ISR };
+
+        static void enable(bool on);
+        static bool is_enabled() { return enabled; }
+        static void reset();
+        static void print(StreamOutput *stream);
+
+        static inline uint32_t now() { return DWT_CYCCNT; }
+
+        // for an interrupt that is not from a timer that resets on its match, it is due in delay cycles from now, only call if enabled
+        static inline void set_due(uint8_t isr, uint32_t delay) { due[isr]= now() + delay; }
+
+        // called at the end of an interrupt handler, entry is now() at its start and since_due the cycles since it was due
+        static void record(uint8_t isr, uint32_t entry, uint32_t since_due);
+        static void record(uint8_t isr, uint32_t entry) { record(isr, entry, now() - due[isr]); }
+
+    private:
+        static const uint8_t n_buckets= 12; // the first is under 128 cycles, each one after that is twice as wide
+        using stats_t= struct {
+            uint32_t count;
+            uint32_t min;
+            uint32_t max;
+            uint32_t histogram[n_buckets];
+        };
+        static void add(stats_t& s, uint32_t cycles);
+        static void print_stats(StreamOutput *stream, const char *name, const stats_t& s);
+
+        static stats_t duration[N_ISR];
+        static stats_t latency[N_ISR];
+        static uint32_t overruns[N_ISR];
+        static uint32_t due[N_ISR];
+        static volatile bool enabled;
+};
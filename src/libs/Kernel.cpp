@@ -47,10 +47,13 @@
 
 #define base_stepping_frequency_checksum            CHECKSUM("base_stepping_frequency")
 #define microseconds_per_step_pulse_checksum        CHECKSUM("microseconds_per_step_pulse")
+#define event_driven_stepping_checksum              CHECKSUM("event_driven_stepping")
 #define disable_leds_checksum                       CHECKSUM("leds_disable")
 #define grbl_mode_checksum                          CHECKSUM("grbl_mode")
 #define feed_hold_enable_checksum                   CHECKSUM("enable_feed_hold")
 #define ok_per_line_checksum                        CHECKSUM("ok_per_line")
+#define binary_protocol_enable_checksum             CHECKSUM("enable_binary_protocol")
+#define ok_buffer_space_checksum                    CHECKSUM("ok_buffer_space")
 
 Kernel* Kernel::instance;
 
@@ -60,6 +63,8 @@ Kernel::Kernel()
     halted = false;
     feed_hold = false;
     enable_feed_hold = false;
+    enable_binary_protocol = false;
+    ok_buffer_space = false;
     bad_mcu= true;
 
     instance = this; // setup the Singleton instance of the kernel
@@ -118,6 +123,12 @@ Kernel::Kernel()
 
     this->enable_feed_hold = this->config->value( feed_hold_enable_checksum )->by_default(this->grbl_mode)->as_bool();
 
+    // lets the host send moves as binary frames on the USB serial, see BinaryProtocol.h
+    this->enable_binary_protocol = this->config->value( binary_protocol_enable_checksum )->by_default(false)->as_bool();
+
+    // ok and the query reply say how many planner blocks and receive buffer bytes are free so the host can send without waiting for each ok
+    this->ok_buffer_space = this->config->value( ok_buffer_space_checksum )->by_default(false)->as_bool();
+
     // we expect ok per line now not per G code, setting this to false will return to the old (incorrect) way of ok per G code
     this->ok_per_line = this->config->value( ok_per_line_checksum )->by_default(true)->as_bool();
 
@@ -162,6 +173,8 @@ Kernel::Kernel()
     // Configure the step ticker
     this->step_ticker->set_frequency( this->base_stepping_frequency );
     this->step_ticker->set_unstep_time( microseconds_per_step_pulse );
+    // only interrupt when a step is due instead of on every tick
+    this->step_ticker->set_event_driven( this->config->value(event_driven_stepping_checksum)->by_default(false)->as_bool() );
 
     // Core modules
     this->add_module( this->conveyor       = new Conveyor()      );
@@ -175,7 +188,7 @@ Kernel::Kernel()
 }
 
 // return a GRBL-like query string for serial ?
-std::string Kernel::get_query_string()
+std::string Kernel::get_query_string(StreamOutput *stream)
 {
     std::string str;
     bool homing;
@@ -286,6 +299,14 @@ std::string Kernel::get_query_string()
         str.append(buf, n);
     }
 
+    // like grbl, free planner blocks and bytes free in the receive buffer of the stream that asked
+    if(ok_buffer_space) {
+        char buf[32];
+        size_t n = snprintf(buf, sizeof(buf), "|Bf:%u,%d", conveyor->get_free_blocks(), stream != nullptr ? stream->rx_space() : -1);
+        if(n > sizeof(buf)) n= sizeof(buf);
+        str.append(buf, n);
+    }
+
     // if not grbl mode get temperatures
     if(!is_grbl_mode()) {
         struct pad_temperature temp;
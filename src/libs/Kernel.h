@@ -24,6 +24,7 @@ class Conveyor;
 class SlowTicker;
 class SerialConsole;
 class StreamOutputPool;
+class StreamOutput;
 class GcodeDispatch;
 class Robot;
 class Planner;
@@ -55,11 +56,13 @@ class Kernel {
         void set_feed_hold(bool f) { feed_hold= f; }
         bool get_feed_hold() const { return feed_hold; }
         bool is_feed_hold_enabled() const { return enable_feed_hold; }
+        bool is_binary_protocol_enabled() const { return enable_binary_protocol; }
+        bool is_ok_buffer_space() const { return ok_buffer_space; }
         void set_bad_mcu(bool b) { bad_mcu= b; }
         bool is_bad_mcu() const { return bad_mcu; }
         void immediate_halt();
 
-        std::string get_query_string();
+        std::string get_query_string(StreamOutput *stream= nullptr);
 
         // These modules are available to all other modules
         SerialConsole*    serial;
@@ -89,6 +92,8 @@ class Kernel {
             bool feed_hold:1;
             bool ok_per_line:1;
             bool enable_feed_hold:1;
+            bool enable_binary_protocol:1;
+            bool ok_buffer_space:1;
             bool bad_mcu:1;
         };
 
@@ -13,6 +13,7 @@
 #include "libs/Hook.h"
 #include "modules/robot/Conveyor.h"
 #include "Gcode.h"
+#include "IsrTiming.h"
 
 #include <mri.h>
 
@@ -123,9 +124,12 @@ void SlowTicker::on_idle(void*)
 }
 
 extern "C" void TIMER2_IRQHandler (void){
+    uint32_t entry= IsrTiming::now();
     if((LPC_TIM2->IR >> 0) & 1){  // If interrupt register set for MR0
         LPC_TIM2->IR |= 1 << 0;   // Reset it
     }
     global_slow_ticker->tick();
+    // the timer is reset on match so it has counted from when this was due
+    if(IsrTiming::is_enabled()) IsrTiming::record(IsrTiming::SLOW_TICKER, entry, LPC_TIM2->TC * 4);
 }
 
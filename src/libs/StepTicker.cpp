@@ -15,10 +15,12 @@
 #include "StreamOutputPool.h"
 #include "Block.h"
 #include "Conveyor.h"
+#include "IsrTiming.h"
 
 #include "system_LPC17xx.h" // mbed.h lib
 #include <math.h>
 #include <mri.h>
+#include <algorithm>
 
 #ifdef STEPTICKER_DEBUG_PIN
 // debug pins, only used if defined in src/makefile
@@ -31,6 +33,8 @@ GPIO stepticker_debug_pin(STEPTICKER_DEBUG_PIN);
 
 StepTicker *StepTicker::instance;
 
+static LPC_GPIO_TypeDef * const gpio_ports[]= {LPC_GPIO0, LPC_GPIO1, LPC_GPIO2, LPC_GPIO3, LPC_GPIO4};
+
 StepTicker::StepTicker()
 {
     instance = this; // setup the Singleton instance of the stepticker
@@ -53,7 +57,32 @@ StepTicker::StepTicker()
     this->num_motors = 0;
 
     this->running = false;
+    this->event_driven = false;
+    this->timer_stretched = false;
     this->current_block = nullptr;
+    this->preparing = false;
+    this->block_done = false;
+    this->prepare_tick = UINT32_MAX;
+    this->hold_request = false;
+    this->drop_block = false;
+
+    this->advance_k.fill(0);
+    this->advance_steps.fill(0);
+    this->advance_wait.fill(0);
+    this->advance_min_ticks.fill(0);
+    this->advance_index.fill(0xFF);
+    this->advance_motors.reset();
+    this->advance_hold.reset();
+    this->advance_busy = false;
+
+    this->step_port.fill(0);
+    this->step_bit.fill(0);
+    this->dir_port.fill(0);
+    this->dir_bit.fill(0);
+    this->dir_inverted.reset();
+    this->step_inverted.fill(0);
+    this->step_bits.fill(0);
+    this->unstep_bits.fill(0);
 
     #ifdef STEPTICKER_DEBUG_PIN
     // setup debug pin if defined
@@ -82,6 +111,11 @@ void StepTicker::set_frequency( float frequency )
     LPC_TIM0->MR0 = this->period;
     LPC_TIM0->TCR = 3;  // Reset
     LPC_TIM0->TCR = 1;  // start
+
+    // in event driven mode never go more than 1ms without a tick, so externally stopped motors are still noticed promptly
+    this->max_skip_ticks = std::max(1.0F, floorf(frequency / 1000.0F));
+    // PendSV gets the next block ready about 1ms before the current one finishes
+    this->prepare_lead_ticks = std::max(1.0F, floorf(frequency / 1000.0F));
 }
 
 // Set the reset delay, must be called after set_frequency
@@ -96,52 +130,134 @@ void StepTicker::set_unstep_time( float microseconds )
 // Reset step pins on any motor that was stepped
 void StepTicker::unstep_tick()
 {
-    for (int i = 0; i < num_motors; i++) {
-        if(this->unstep[i]) {
-            this->motor[i]->unstep();
-        }
+    for (uint8_t p = 0; p < n_ports; p++) {
+        uint32_t b= unstep_bits[p];
+        if(b == 0) continue;
+        if(b & ~step_inverted[p]) gpio_ports[p]->FIOCLR= b & ~step_inverted[p];
+        if(b & step_inverted[p]) gpio_ports[p]->FIOSET= b & step_inverted[p];
+        unstep_bits[p]= 0;
     }
     this->unstep.reset();
 }
 
+// counts a step of the motor, its step pin is set with the others on the same port at the end of the tick
+inline bool StepTicker::step_motor(uint8_t m)
+{
+    step_bits[step_port[m]] |= step_bit[m];
+    unstep.set(m);
+    return motor[m]->count_step(); // returns false if the moving flag was set to false externally (probes, endstops etc)
+}
+
+// sets the step pins of all the motors that stepped on this tick, one write per port, and has the unstep ISR reset them
+void StepTicker::set_step_pins()
+{
+    for (uint8_t p = 0; p < n_ports; p++) {
+        uint32_t b= step_bits[p];
+        if(b == 0) continue;
+        if(b & ~step_inverted[p]) gpio_ports[p]->FIOSET= b & ~step_inverted[p];
+        if(b & step_inverted[p]) gpio_ports[p]->FIOCLR= b & step_inverted[p];
+        unstep_bits[p] |= b;
+        step_bits[p]= 0;
+    }
+
+    if(IsrTiming::is_enabled()) IsrTiming::set_due(IsrTiming::UNSTEP, LPC_TIM1->MR0 * 4);
+    LPC_TIM1->TCR = 3;
+    LPC_TIM1->TCR = 1;
+}
+
 extern "C" void TIMER1_IRQHandler (void)
 {
+    uint32_t entry= IsrTiming::now();
     LPC_TIM1->IR |= 1 << 0;
     StepTicker::getInstance()->unstep_tick();
+    if(IsrTiming::is_enabled()) IsrTiming::record(IsrTiming::UNSTEP, entry);
 }
 
 // The actual interrupt handler where we do all the work
 extern "C" void TIMER0_IRQHandler (void)
 {
+    uint32_t entry= IsrTiming::now();
     // Reset interrupt register
     LPC_TIM0->IR |= 1 << 0;
     StepTicker::getInstance()->step_tick();
+    // the timer is reset on match so it has counted (at a quarter of the core clock) from when this was due
+    if(IsrTiming::is_enabled()) IsrTiming::record(IsrTiming::STEP, entry, LPC_TIM0->TC * 4);
 }
 
 extern "C" void PendSV_Handler(void)
 {
+    uint32_t entry= IsrTiming::now();
     StepTicker::getInstance()->handle_finish();
+    if(IsrTiming::is_enabled()) IsrTiming::record(IsrTiming::PENDSV, entry);
 }
 
-// slightly lower priority than TIMER0, the whole end of block/start of block is done here allowing the timer to continue ticking
+// slightly lower priority than TIMER0, gets the block after the current one ready while the current one is stepped
+// so at the end of the block the step ISR only has to switch to it
 void StepTicker::handle_finish (void)
 {
+    // set first so the step ISR leaves the queue alone if it interrupts us
+    preparing= true;
+    if(running && next_block == nullptr && !block_done) {
+        Block *b;
+        if(THECONVEYOR->get_following_block(&b)) {
+            setup_block(b, setup);
+            next_block= b;
+        }
+    }
+    preparing= false;
+
     // all moves finished signal block is finished
     if(finished_fnc) finished_fnc();
 }
 
+void StepTicker::prepare_next_block()
+{
+    if(running && next_block == nullptr) {
+        if(IsrTiming::is_enabled()) IsrTiming::set_due(IsrTiming::PENDSV, 0);
+        SCB->ICSR = SCB_ICSR_PENDSVSET_Msk;
+    }
+}
+
 // step clock
 void StepTicker::step_tick (void)
 {
     //SET_STEPTICKER_DEBUG_PIN(running ? 1 : 0);
 
+    if(drop_block) {
+        // a feed hold has stopped the block part way and the rest of it is not wanted
+        drop_block= false;
+        if(running && hold_scale == 0) {
+            for (uint8_t m = 0; m < num_motors; m++) {
+                if(motor[m]->is_moving()) motor[m]->stop_moving();
+            }
+            running= false;
+            current_tick= 0;
+            current_block= nullptr;
+            block_done= true; // it is given back to the conveyor when the flushed queue is next looked at
+            advance_index.fill(0xFF);
+            advance_hold.reset();
+            advance_busy= advance_motors.any();
+            if(step_sync_fnc) step_sync_fnc();
+        }
+    }
+
+    bool hold= hold_request || THEKERNEL->get_feed_hold();
+
     // if nothing has been setup we ignore the ticks
     if(!running){
+        // there is nothing to slow down so a feed hold stops here, a new block does not start until it is released
+        hold_scale= hold ? 0 : HOLD_ONE;
+
         // check if anything new available
-        if(THECONVEYOR->get_next_block(&current_block)) { // returns false if no new block is available
+        if(!hold && fetch_next_block()) { // returns false if no new block is available
             running= start_next_block(); // returns true if there is at least one motor with steps to issue
             if(!running) return;
         }else{
+            // nothing is moving so any pressure advance that is left goes back to 0
+            if(advance_busy && !THEKERNEL->is_halted()) {
+                advance_tick();
+                if(unstep.any()) set_step_pins();
+            }
             return;
         }
     }
@@ -150,73 +266,179 @@ void StepTicker::step_tick (void)
         running= false;
         current_tick = 0;
         current_block= nullptr;
+        // the queue is flushed so any block that was got ready goes with it
+        next_block= nullptr;
+        block_done= false;
+        // the position is reset from where the motors actually are
+        advance_steps.fill(0);
+        advance_hold.reset();
+        advance_busy= false;
         return;
     }
 
+    // during a feed hold the moves slow down, stop and speed up again by only running them on some of the ticks
+    bool holding= hold || hold_scale != HOLD_ONE;
+    if(holding && !hold_tick(hold)) return;
+
+    // acceleration events happen on the same tick for all the motors in the block
+    bool accel_event= (current_tick == current_block->next_accel_event);
+    bool end_of_accel= accel_event && current_tick == current_block->accelerate_until;
+    bool start_of_decel= accel_event && current_tick == current_block->decelerate_after;
+
+    // S-curve, the jerk events also happen on the same tick for all the motors
+    Block::jerkinfo_t *jerk_info= current_block->jerk_info();
+    bool s_curve= current_block->jerk_phase != Block::NO_JERK;
+    while(current_tick == current_block->next_jerk_event) {
+        if(current_block->shaper != nullptr) {
+            // input shaping, each impulse of the shaper steps the acceleration by its part of the peak acceleration of the ramp
+            bool decel= current_block->jerk_phase >= Block::DECEL_JERK_UP;
+            int32_t a= current_block->next_shaper_impulse();
+            for (uint8_t i = 0; i < current_block->n_active; i++) {
+                const Block::jerkinfo_t& ji= jerk_info[i];
+                current_block->tick_info[i].acceleration_change += Block::unpack(decel ? ji.decel_jerk : ji.accel_jerk, current_block->jerk_shift) * a;
+            }
+            continue;
+        }
+
+        uint8_t phase= current_block->jerk_phase;
+        uint8_t shift= current_block->jerk_shift;
+        for (uint8_t i = 0; i < current_block->n_active; i++) {
+            Block::jerkinfo_t& ji= jerk_info[i];
+            switch(phase) {
+                case Block::ACCEL_JERK_UP:   ji.jerk= Block::unpack(ji.accel_jerk, shift); break;
+                case Block::ACCEL_JERK_DOWN: ji.jerk= -Block::unpack(ji.accel_jerk, shift); break;
+                case Block::DECEL_JERK_UP:   ji.jerk= -Block::unpack(ji.decel_jerk, shift); break;
+                case Block::DECEL_JERK_DOWN: ji.jerk= Block::unpack(ji.decel_jerk, shift); break;
+                default: ji.jerk= 0;
+            }
+        }
+
+        // move on to the next phase, skipping the deceleration ramp if it is not an S-curve
+        ++phase;
+        if(phase == Block::DECEL_JERK_UP && current_block->decel_jerk_ticks == 0) phase= Block::NO_JERK;
+        current_block->jerk_phase= phase;
+        current_block->next_jerk_event= current_block->jerk_event_tick(phase);
+    }
+
+    bool shaper_wait= current_block->shaper != nullptr && current_block->jerk_phase == Block::ACCEL_JERK_UP && current_block->shaper_impulse == 0;
+    bool overdue= current_tick >= current_block->total_move_ticks;
     bool still_moving= false;
-    // foreach motor, if it is active see if time to issue a step to that motor
-    for (uint8_t m = 0; m < num_motors; m++) {
-        if(current_block->tick_info[m].steps_to_move == 0) continue; // not active
-
-        current_block->tick_info[m].steps_per_tick += current_block->tick_info[m].acceleration_change;
-
-        if(current_tick == current_block->tick_info[m].next_accel_event) {
-            if(current_tick == current_block->accelerate_until) { // We are done accelerating, deceleration becomes 0 : plateau
-                current_block->tick_info[m].acceleration_change = 0;
-                if(current_block->decelerate_after < current_block->total_move_ticks) {
-                    current_block->tick_info[m].next_accel_event = current_block->decelerate_after;
-                    if(current_tick != current_block->decelerate_after) { // We are plateauing
-                        // steps/sec / tick frequency to get steps per tick
-                        current_block->tick_info[m].steps_per_tick = current_block->tick_info[m].plateau_rate;
-                    }
+    bool sync_due= false;
+    // foreach motor that moves in this block see if time to issue a step to that motor
+    for (uint8_t i = 0; i < current_block->n_active; i++) {
+        Block::tickinfo_t& ti= current_block->tick_info[i];
+        if(ti.steps_to_move == 0) continue; // finished
+
+        if(s_curve) ti.acceleration_change += jerk_info[i].jerk;
+        ti.steps_per_tick += ti.acceleration_change;
+
+        if(accel_event) {
+            if(end_of_accel) { // We are done accelerating, deceleration becomes 0 : plateau
+                ti.acceleration_change = 0;
+                if(current_block->decelerate_after < current_block->total_move_ticks && !start_of_decel) { // We are plateauing
+                    // steps/sec / tick frequency to get steps per tick
+                    ti.steps_per_tick = Block::unpack_rate(current_block->ramp_info()[i].plateau_rate);
                 }
             }
 
-            if(current_tick == current_block->decelerate_after) { // We start decelerating
-                current_block->tick_info[m].acceleration_change = current_block->tick_info[m].deceleration_change;
+            if(start_of_decel) { // We start decelerating
+                ti.acceleration_change = Block::unpack(current_block->ramp_info()[i].deceleration_change, current_block->ramp_shift);
             }
         }
 
-        // protect against rounding errors and such
-        if(current_block->tick_info[m].steps_per_tick <= 0) {
-            current_block->tick_info[m].counter = STEPTICKER_FPSCALE; // we force completion this step by setting to 1.0
-            current_block->tick_info[m].steps_per_tick = 0;
+        // protect against rounding errors and such, but a shaped ramp from a standstill does not move until the first impulse of the shaper
+        // an S-curve or shaped ramp ends with no deceleration left to take the rate below zero, so rounding can leave it crawling
+        // towards the last step, any steps that are left when the block should have finished are forced the same way
+        if((ti.steps_per_tick <= 0 && !shaper_wait) || (overdue && jerk_info != nullptr)) {
+            ti.counter = STEPTICKER_FPSCALE; // we force completion this step by setting to 1.0
+            ti.steps_per_tick = 0;
         }
 
-        current_block->tick_info[m].counter += current_block->tick_info[m].steps_per_tick;
+        ti.counter += ti.steps_per_tick;
+
+        if(ti.counter >= STEPTICKER_FPSCALE) { // >= 1.0 step time
+            ti.counter -= STEPTICKER_FPSCALE; // -= 1.0F;
+            ++ti.step_count;
 
-        if(current_block->tick_info[m].counter >= STEPTICKER_FPSCALE) { // >= 1.0 step time
-            current_block->tick_info[m].counter -= STEPTICKER_FPSCALE; // -= 1.0F;
-            ++current_block->tick_info[m].step_count;
+            if(i == step_sync_index && ++step_sync_count >= step_sync_steps) {
+                step_sync_count= 0;
+                sync_due= true;
+            }
 
-            // step the motor
-            bool ismoving= motor[m]->step(); // returns false if the moving flag was set to false externally (probes, endstops etc)
-            // we stepped so schedule an unstep
-            unstep.set(m);
+            uint8_t m= current_block->active_motors[i];
+            if(m == Block::ARC_PATH) {
+                // a step along the arc, the plane axes are stepped as they become due
+                bool last= ti.step_count == ti.steps_to_move;
+                if(arc_step(last) && last) {
+                    // if the plane axes have not quite got to the end keep stepping at this rate until they have
+                    --ti.step_count;
+                }else if(last) {
+                    ti.steps_to_move = 0;
+                    continue;
+                }
+                still_moving= true;
+                continue;
+            }
 
-            if(!ismoving || current_block->tick_info[m].step_count == current_block->tick_info[m].steps_to_move) {
+            bool ismoving;
+            if(!advance_hold[m]) {
+                // step the motor, this also schedules the unstep
+                ismoving= step_motor(m);
+
+            }else{
+                // pressure advance wants this motor to fall back a step, so this one is not issued
+                advance_hold.reset(m);
+                advance_steps[m] += motor[m]->which_direction() ? 1 : -1;
+                ismoving= motor[m]->is_moving();
+            }
+
+            if(!ismoving || ti.step_count == ti.steps_to_move) {
                 // done
-                current_block->tick_info[m].steps_to_move = 0;
+                ti.steps_to_move = 0;
                 motor[m]->stop_moving(); // let motor know it is no longer moving
+                continue;
             }
         }
 
         // see if any motors are still moving after this tick
-        if(motor[m]->is_moving()) still_moving= true;
+        uint8_t m= current_block->active_motors[i];
+        if(m == Block::ARC_PATH || motor[m]->is_moving()) still_moving= true;
+    }
+
+    if(end_of_accel && current_block->decelerate_after < current_block->total_move_ticks) {
+        current_block->next_accel_event = current_block->decelerate_after;
     }
 
+    if(sync_due) step_sync_fnc();
+
+    if(advance_motors.any()) advance_tick();
+
     // do this after so we start at tick 0
     current_tick++; // count number of ticks
 
-    // We may have set a pin on in this tick, now we reset the timer to set it off
-    // Note there could be a race here if we run another tick before the unsteps have happened,
-    // right now it takes about 3-4us but if the unstep were near 10uS or greater it would be an issue
-    // also it takes at least 2us to get here so even when set to 1us pulse width it will still be about 3us
-    if( unstep.any()) {
-        LPC_TIM1->TCR = 3;
-        LPC_TIM1->TCR = 1;
+    if(current_tick >= prepare_tick) {
+        prepare_tick= UINT32_MAX;
+        prepare_next_block();
     }
 
+    if(event_driven && still_moving && !holding) {
+        // if no motor can step for the next n ticks then do those ticks now and have the timer fire when the next step is due
+        uint32_t n= ticks_to_next_step();
+        if(n > 0) {
+            skip_ticks(n);
+            LPC_TIM0->MR0 = period * (n + 1);
+            timer_stretched= true;
+
+        }else if(timer_stretched) {
+            restore_timer_period();
+        }
+    }
+
+    // We may have stepped in this tick, the step pins of all the motors go on together now and the timer is reset to set them off
+    // Note there could be a race here if we run another tick before the unsteps have happened,
+    // as the pins are only set here at the end of the tick that is now well under the step period even with a long pulse
+    if( unstep.any()) set_step_pins();
+
 
     // see if any motors are still moving
     if(!still_moving) {
@@ -226,61 +448,401 @@ void StepTicker::step_tick (void)
         current_tick = 0;
 
         // get next block
-        // do it here so there is no delay in ticks
-        THECONVEYOR->block_finished();
+        // do it here so there is no delay in ticks, normally PendSV already has it ready
+        block_done= true;
+        running= fetch_next_block() && start_next_block(); // returns true if there is at least one motor with steps to issue
 
-        if(THECONVEYOR->get_next_block(&current_block)) { // returns false if no new block is available
-            running= start_next_block(); // returns true if there is at least one motor with steps to issue
-
-        }else{
+        if(!running) {
             current_block= nullptr;
-            running= false;
+            advance_index.fill(0xFF);
+            advance_hold.reset();
+            advance_busy= advance_motors.any();
+            // a new block does this in start_next_block()
+            if(step_sync_fnc) step_sync_fnc();
         }
 
-        // all moves finished
-        // we delegate the slow stuff to the pendsv handler which will run as soon as this interrupt exits
-        //NVIC_SetPendingIRQ(PendSV_IRQn); this doesn't work
-        //SCB->ICSR = 0x10000000; // SCB_ICSR_PENDSVSET_Msk;
+        if(timer_stretched) restore_timer_period();
     }
 }
 
+// gets the block to run next, the one PendSV got ready if there is one, returns false if there is none yet
 // only called from the step tick ISR (single consumer)
+bool StepTicker::fetch_next_block()
+{
+    // PendSV was interrupted part way through getting the next block, it will have it on the next tick
+    if(preparing) return false;
+
+    if(block_done) {
+        THECONVEYOR->block_finished();
+        block_done= false;
+    }
+
+    Block *b= next_block;
+    if(b != nullptr) {
+        next_block= nullptr;
+        // unless it was flushed along with the rest of the queue
+        if(THECONVEYOR->take_following_block(b)) {
+            current_block= b;
+            return true;
+        }
+    }
+
+    if(!THECONVEYOR->get_next_block(&current_block)) return false;
+    setup_block(current_block, setup);
+    return true;
+}
+
+// works out what start_next_block() needs for the block, this does not touch the motors so it can be done ahead of time
+void StepTicker::setup_block(const Block *block, block_setup_t& s) const
+{
+    uint32_t max_steps= 0;
+    s.moving.reset();
+    s.direction= block->direction_bits;
+    s.advance_index.fill(0xFF);
+    s.step_sync_index= 0xFF;
+    s.primary_index= 0;
+
+    for (uint8_t i = 0; i < block->n_active; i++) {
+        // the step sync counts the steps of the motor with the most steps (or the path of an arc)
+        if(block->tick_info[i].steps_to_move > max_steps) {
+            max_steps= block->tick_info[i].steps_to_move;
+            s.primary_index= i;
+            if(step_sync_fnc) s.step_sync_index= i;
+        }
+
+        uint8_t m= block->active_motors[i];
+        if(m == Block::ARC_PATH) {
+            // the plane axes of an arc do not have an entry of their own
+            const Block::arcinfo_t *ai= block->arc_info();
+            for (int k = 0; k < 2; ++k) {
+                if(ai->steps_to_move[k] != 0) s.moving.set(ai->motor[k]);
+            }
+            continue;
+        }
+
+        s.advance_index[m]= i;
+        s.moving.set(m);
+    }
+}
+
+// only called from the step tick ISR (single consumer), setup has what is needed for current_block
 bool StepTicker::start_next_block()
 {
     if(current_block == nullptr) return false;
 
-    bool ok= false;
-    // need to prepare each active motor
+    advance_index= setup.advance_index;
+    advance_hold.reset();
+    step_sync_index= setup.step_sync_index;
+    primary_index= setup.primary_index;
+    std::array<uint32_t, n_ports> dir_set{}, dir_clr{};
     for (uint8_t m = 0; m < num_motors; m++) {
-        if(current_block->tick_info[m].steps_to_move == 0) continue;
-
-        ok= true; // mark at least one motor is moving
+        if(!setup.moving[m]) continue;
         // set direction bit here
         // NOTE this would be at least 10us before first step pulse.
         // TODO does this need to be done sooner, if so how without delaying next tick
-        motor[m]->set_direction(current_block->direction_bits[m]);
+        motor[m]->set_direction_flag(setup.direction[m]);
+        if(setup.direction[m] ^ dir_inverted[m]) dir_set[dir_port[m]] |= dir_bit[m];
+        else dir_clr[dir_port[m]] |= dir_bit[m];
         motor[m]->start_moving(); // also let motor know it is moving now
     }
+    for (uint8_t p = 0; p < n_ports; p++) {
+        if(dir_set[p] != 0) gpio_ports[p]->FIOSET= dir_set[p];
+        if(dir_clr[p] != 0) gpio_ports[p]->FIOCLR= dir_clr[p];
+    }
 
     current_tick= 0;
 
-    if(ok) {
+    if(current_block->n_active > 0) {
         //SET_STEPTICKER_DEBUG_PIN(1);
+        if(step_sync_fnc) {
+            step_sync_count= 0;
+            step_sync_fnc();
+        }
+
+        // PendSV gets the block after this one ready shortly before this one finishes, until then the planner can still improve it
+        prepare_tick= (current_block->total_move_ticks > prepare_lead_ticks) ? current_block->total_move_ticks - prepare_lead_ticks : 0;
         return true;
 
     }else{
         // this is an edge condition that should never happen, but we need to discard this block if it ever does
         // basically it is a block that has zero steps for all motors
-        THECONVEYOR->block_finished();
+        block_done= true;
     }
 
     return false;
 }
 
 
+// v * m >> shift for a 32.32 fixed point v and a 1.31 mantissa, shift is 32 to 94
+static inline int64_t fixed_multiply(int64_t v, int32_t m, uint8_t shift)
+{
+    // done as two 32x32 multiplies, each part is rounded down so the result may be one less than exact
+    int64_t hi= (int64_t)(int32_t)(v >> 32) * m;
+    int64_t lo= (int64_t)(uint32_t)v * m;
+    return (hi >> (shift - 32)) + (lo >> std::min<uint8_t>(shift, 63));
+}
+
+// called for each step along an arc, moves the position of the plane axes round the circle by one path step (or to the
+// end on the last one) and steps each plane axis that has got to its next step, at most one step per call
+// returns true if a plane axis still has steps to do
+bool StepTicker::arc_step(bool last)
+{
+    Block::arcinfo_t& ai= *current_block->arc_info();
+
+    if(last) {
+        ai.pos[0]= ai.end[0];
+        ai.pos[1]= ai.end[1];
+
+    }else{
+        int64_t u= ai.pos[0], v= ai.pos[1];
+        ai.pos[0]= u - fixed_multiply(u, ai.cos_m, ai.cos_shift) - fixed_multiply(v, ai.sin_m[0], ai.sin_shift[0]);
+        ai.pos[1]= v - fixed_multiply(v, ai.cos_m, ai.cos_shift) + fixed_multiply(u, ai.sin_m[1], ai.sin_shift[1]);
+    }
+
+    bool more= false;
+    for (int k = 0; k < 2; ++k) {
+        if(ai.steps_to_move[k] == 0) continue; // finished
+
+        if(ai.forward[k] ? ai.pos[k] >= ai.next[k] : ai.pos[k] <= ai.next[k]) {
+            ai.next[k] += ai.forward[k] ? (1LL<<32) : -(1LL<<32);
+            uint8_t m= ai.motor[k];
+            bool ismoving= step_motor(m);
+            if(!ismoving || ++ai.step_count[k] == ai.steps_to_move[k]) {
+                ai.steps_to_move[k]= 0;
+                motor[m]->stop_moving();
+                continue;
+            }
+        }
+        more= true;
+    }
+
+    return more;
+}
+
+void StepTicker::set_pressure_advance(uint8_t m, float seconds)
+{
+    advance_k[m]= (int64_t)(seconds * frequency * (1 << 20));
+    advance_motors[m]= advance_k[m] > 0;
+
+    // the advance steps are not issued faster than the motor can go
+    float rate= motor[m]->get_max_rate() * motor[m]->get_steps_per_mm();
+    advance_min_ticks[m]= rate > 0 ? floorf(frequency / rate) : 0;
+}
+
+// called from the main loop, so the ISR can move on to the next block while this reads the current one, which is still in the queue
+uint32_t StepTicker::get_stop_time_us() const
+{
+    const Block *b= current_block;
+    if(!running || b == nullptr || b->millimeters <= 0.0F || b->acceleration <= 0.0F) return 0;
+
+    // the block may still be accelerating so go from its top speed, in mm/s
+    float speed= b->maximum_rate * b->millimeters / b->steps_event_count;
+    return lroundf(speed * get_hold_scale() / b->acceleration * 1000000.0F);
+}
+
+// called on each tick during a feed hold, the moves are advanced by hold_scale of a tick on each tick so they follow the same path
+// at hold_scale times their speed, it ramps down to 0 and back up to 1 when the hold is released
+// the acceleration is then the rate hold_scale changes times the speed of the move plus hold_scale² times the acceleration of the move,
+// so how fast it changes is limited to keep that within the acceleration of the block
+// hold is set while the feed hold is on, returns true if the moves advance by a tick on this tick
+bool StepTicker::hold_tick(bool hold)
+{
+    if(hold_block != current_block) {
+        // the acceleration of the primary axis in the same units as its steps_per_tick changes by each tick
+        hold_block= current_block;
+        hold_acceleration= (int64_t)((double)current_block->acceleration * current_block->steps_event_count / current_block->millimeters
+                                     / ((double)frequency * frequency) * STEPTICKER_FPSCALE);
+    }
+
+    // every tick is needed to time the steps
+    if(timer_stretched) restore_timer_period();
+
+    const Block::tickinfo_t& ti= current_block->tick_info[primary_index];
+
+    // the part of the acceleration of the move that goes the same way as the ramp uses up some of what is allowed
+    int64_t a= hold ? -ti.acceleration_change : ti.acceleration_change;
+    int64_t allowed= hold_acceleration;
+    if(a > 0) allowed -= (a >> 31) * (int64_t)(((uint64_t)hold_scale * hold_scale) >> 31);
+
+    // the change in hold_scale per tick is the allowed acceleration over the speed, both in steps per tick
+    int64_t v= ti.steps_per_tick >> 31;
+    uint32_t ds= 0;
+    if(v <= 0) ds= HOLD_ONE; // not moving so there is nothing to ramp
+    else if(allowed > 0) ds= std::min<int64_t>(allowed / v, HOLD_ONE);
+
+    if(hold) {
+        hold_scale= (hold_scale > ds) ? hold_scale - ds : 0;
+    }else{
+        hold_scale= (HOLD_ONE - hold_scale > ds) ? hold_scale + ds : HOLD_ONE;
+    }
+
+    hold_phase += hold_scale;
+    if(hold_phase < HOLD_ONE) return false;
+    hold_phase -= HOLD_ONE;
+    return true;
+}
+
+// called on each tick, keeps each motor that uses pressure advance ahead of the move by its advance times its current rate,
+// an advance step goes the way the motor is moving in the block, to fall back its next step in the block is held back instead
+// so the motor only changes direction when it does not move in the block, at the end of a move the advance goes back to 0
+void StepTicker::advance_tick()
+{
+    advance_busy= false;
+    for (uint8_t m = 0; m < num_motors; m++) {
+        if(!advance_motors[m]) continue;
+
+        if(advance_wait[m] > 0) {
+            --advance_wait[m];
+            advance_busy= true;
+            continue;
+        }
+
+        // still waiting for the held back step
+        if(advance_hold[m]) {
+            advance_busy= true;
+            continue;
+        }
+
+        // only extrusion along with a primary axis move is advanced, the rate has 62 fractional bits
+        uint8_t i= advance_index[m];
+        int32_t target= 0;
+        if(i != 0xFF && current_block->primary_axis) {
+            int32_t a= ((current_block->tick_info[i].steps_per_tick >> 42) * advance_k[m]) >> 40;
+            target= current_block->direction_bits[m] ? -a : a;
+        }
+
+        int32_t error= target - advance_steps[m];
+        if(error == 0) continue;
+        advance_busy= true;
+
+        bool dir= error < 0; // same sense as the direction bits, set is backwards
+        if(i != 0xFF) {
+            if(dir != current_block->direction_bits[m]) {
+                advance_hold.set(m);
+                continue;
+            }
+            // already stepped on this tick
+            if(unstep[m]) continue;
+
+        }else if(motor[m]->which_direction() != dir) {
+            // it does not move in this block so it can change direction, the step is on the next tick so the driver sees the direction first
+            motor[m]->set_direction(dir);
+            advance_wait[m]= 1;
+            continue;
+        }
+
+        step_motor(m);
+        advance_steps[m] += dir ? -1 : 1;
+        advance_wait[m]= advance_min_ticks[m];
+    }
+}
+
+// Event driven mode, returns how many ticks from now can be skipped because no motor will step and no acceleration event is due
+// the rate may change linearly during the skipped ticks, so a bound on the rate is used, this can be early but never late
+uint32_t StepTicker::ticks_to_next_step() const
+{
+    uint32_t n= max_skip_ticks;
+
+    // pressure advance is still catching up
+    if(advance_busy) return 0;
+
+    // the tick where the next acceleration event is due must be done for real
+    if(current_block->next_accel_event >= current_tick) {
+        uint32_t e= current_block->next_accel_event - current_tick;
+        if(e < n) n= e;
+        if(n == 0) return 0;
+    }
+
+    // as is the tick where the next jerk event is due
+    if(current_block->next_jerk_event >= current_tick) {
+        uint32_t e= current_block->next_jerk_event - current_tick;
+        if(e < n) n= e;
+        if(n == 0) return 0;
+    }
+
+    // and the end of an S-curve or shaped block, where the steps that are left are forced
+    const Block::jerkinfo_t *jerk_info= current_block->jerk_info();
+    if(jerk_info != nullptr && current_block->total_move_ticks >= current_tick) {
+        uint32_t e= current_block->total_move_ticks - current_tick;
+        if(e < n) n= e;
+        if(n == 0) return 0;
+    }
+
+    // and the tick where PendSV is asked to get the next block ready
+    if(prepare_tick >= current_tick) {
+        uint32_t e= prepare_tick - current_tick;
+        if(e < n) n= e;
+        if(n == 0) return 0;
+    }
+
+    for (uint8_t i = 0; i < current_block->n_active; i++) {
+        const Block::tickinfo_t& ti= current_block->tick_info[i];
+        if(ti.steps_to_move == 0) continue; // finished
+        // while the jerk is changing the acceleration the rate is not linear so every tick is done
+        if(jerk_info != nullptr && jerk_info[i].jerk != 0) return 0;
+
+        int64_t rate= ti.steps_per_tick;
+        if(rate <= 0) return 0;
+
+        int64_t accel= ti.acceleration_change;
+        if(accel > 0) {
+            // accelerating, the rate will be highest on the last skipped tick
+            rate += accel * n;
+
+        }else if(accel < 0) {
+            // decelerating, the rate must not get to zero in the skipped ticks
+            int64_t z= (rate - 1) / -accel;
+            if(z < n) n= z;
+        }
+
+        // ticks before the counter gets to 1.0 at this rate
+        int64_t remaining= STEPTICKER_FPSCALE - 1 - ti.counter;
+        if(remaining < rate) return 0;
+        int64_t k= remaining / rate;
+        if(k < n) n= k;
+        if(n == 0) return 0;
+    }
+
+    return n;
+}
+
+// Event driven mode, do n ticks in one go for all the active motors, none of these ticks will issue a step
+void StepTicker::skip_ticks(uint32_t n)
+{
+    int64_t sum= (int64_t)n * (n + 1) / 2;
+    for (uint8_t i = 0; i < current_block->n_active; i++) {
+        Block::tickinfo_t& ti= current_block->tick_info[i];
+        if(ti.steps_to_move == 0) continue; // finished
+
+        ti.counter += ti.steps_per_tick * n + ti.acceleration_change * sum;
+        ti.steps_per_tick += ti.acceleration_change * n;
+    }
+
+    current_tick += n;
+}
+
+// Event driven mode, go back to ticking at the base frequency
+void StepTicker::restore_timer_period()
+{
+    LPC_TIM0->MR0 = period;
+    // if we are already past the new match point the timer would have to wrap, so make it fire now
+    if(LPC_TIM0->TC >= period) LPC_TIM0->TC = period - 1;
+    timer_stretched= false;
+}
+
 // returns index of the stepper motor in the array and bitset
 int StepTicker::register_motor(StepperMotor* m)
 {
+    // the pins are grouped by port so the step ISR can set them all with one write per port
+    const Pin& step= m->get_step_pin();
+    const Pin& dir= m->get_dir_pin();
+    step_port[num_motors]= step.connected() ? step.port_number : 0;
+    step_bit[num_motors]= step.connected() ? 1UL << step.pin : 0;
+    if(step.connected() && step.is_inverting()) step_inverted[step.port_number] |= 1UL << step.pin;
+    dir_port[num_motors]= dir.connected() ? dir.port_number : 0;
+    dir_bit[num_motors]= dir.connected() ? 1UL << dir.pin : 0;
+    dir_inverted[num_motors]= dir.is_inverting();
+
     motor[num_motors++] = m;
     return num_motors - 1;
 }
@@ -31,6 +31,7 @@ class StepTicker{
         ~StepTicker();
         void set_frequency( float frequency );
         void set_unstep_time( float microseconds );
+        void set_event_driven( bool flg ) { event_driven= flg; }
         int register_motor(StepperMotor* motor);
         float get_frequency() const { return frequency; }
         void unstep_tick();
@@ -40,26 +41,110 @@ class StepTicker{
         void handle_finish (void);
         void start();
 
+        // have PendSV get the block after the current one ready if it does not have one yet
+        void prepare_next_block();
+
         // whatever setup the block should register this to know when it is done
         std::function<void()> finished_fnc{nullptr};
 
+        // fnc is called from the step ISR when a block starts, every steps steps of the block's primary axis and when
+        // stepping stops, so things like the laser power can follow the speed as it changes
+        void set_step_sync(std::function<void()> fnc, uint32_t steps) { step_sync_steps= steps; step_sync_fnc= fnc; }
+
+        // pressure advance, the motor (an extruder) is kept ahead of the move by seconds times its step rate, 0 turns it off
+        void set_pressure_advance(uint8_t motor, float seconds);
+
+        // feed hold, the moves slow down to a stop within their acceleration and carry on from where they stopped once released,
+        // this is also done while the kernel is in feed hold
+        void set_hold(bool flg) { hold_request= flg; }
+        bool is_held() const { return hold_scale == 0; }
+        // the fraction of its planned speed the move is running at, less than 1 during a feed hold
+        float get_hold_scale() const { return (float)hold_scale / HOLD_ONE; }
+        // the time in us a feed hold takes to stop the current block from its top speed at its acceleration, 0 if nothing is moving
+        uint32_t get_stop_time_us() const;
+        // drops what is left of the block that is stopped by set_hold(), the queue has to be flushed too
+        void drop_held_block() { drop_block= true; }
+
         static StepTicker *getInstance() { return instance; }
         std::array<StepperMotor*, k_max_actuators> motor;
 
     private:
         static StepTicker *instance;
 
+        // what start_next_block() needs to start a block, worked out ahead of time in PendSV so the step ISR can just switch to it
+        using block_setup_t= struct {
+            std::bitset<k_max_actuators> moving;                 // the motors that move, including the plane axes of an arc
+            std::bitset<k_max_actuators> direction;
+            std::array<uint8_t, k_max_actuators> advance_index;  // the tick_info entry for each motor, 0xFF if none
+            uint8_t step_sync_index;
+            uint8_t primary_index;                               // the tick_info entry with the most steps
+        };
+        void setup_block(const Block *block, block_setup_t& setup) const;
+        bool fetch_next_block();
         bool start_next_block();
+        bool arc_step(bool last);
+        void advance_tick();
+        inline bool step_motor(uint8_t m);
+        void set_step_pins();
+        bool hold_tick(bool hold);
+        uint32_t ticks_to_next_step() const;
+        void skip_ticks(uint32_t n);
+        void restore_timer_period();
 
         float frequency;
         uint32_t period;
+        uint32_t max_skip_ticks;
+        uint32_t prepare_lead_ticks;
+        uint32_t prepare_tick; // the tick of the current block to have PendSV get the next block ready on
         std::bitset<k_max_actuators> unstep;
 
+        // the step and dir pins of the motors grouped by GPIO port, so a tick sets the pins on a port with one register write
+        static const uint8_t n_ports= 5;
+        std::array<uint8_t, k_max_actuators> step_port;    // the port of the step pin of each motor
+        std::array<uint32_t, k_max_actuators> step_bit;    // its bit on the port, 0 if it is not connected
+        std::array<uint8_t, k_max_actuators> dir_port;
+        std::array<uint32_t, k_max_actuators> dir_bit;
+        std::bitset<k_max_actuators> dir_inverted;
+        std::array<uint32_t, n_ports> step_inverted;       // the step pins on each port that go low for a step
+        std::array<uint32_t, n_ports> step_bits;           // the step pins on each port to set at the end of this tick
+        std::array<uint32_t, n_ports> unstep_bits;         // the step pins on each port to reset in the unstep ISR
+
         Block *current_block;
         uint32_t current_tick{0};
+        Block * volatile next_block{nullptr}; // the block after the current one, set up by PendSV
+        block_setup_t setup;                  // for the next block if there is one, otherwise for the current one
+
+        std::function<void()> step_sync_fnc{nullptr};
+        uint32_t step_sync_steps{0};
+        uint32_t step_sync_count{0};
+        uint8_t step_sync_index{0xFF}; // the tick_info entry that is counted, 0xFF if there is no step sync
+
+        // pressure advance state for each motor
+        std::array<int64_t, k_max_actuators> advance_k;          // seconds * tick frequency, 20 fractional bits
+        std::array<int32_t, k_max_actuators> advance_steps;      // steps the motor is ahead of the move, signed
+        std::array<uint32_t, k_max_actuators> advance_wait;      // ticks before the next advance step can be issued
+        std::array<uint32_t, k_max_actuators> advance_min_ticks; // fewest ticks between advance steps, from the max rate
+        std::array<uint8_t, k_max_actuators> advance_index;      // the tick_info entry for the motor in the current block, 0xFF if none
+        std::bitset<k_max_actuators> advance_motors;             // set for the motors that use pressure advance
+        std::bitset<k_max_actuators> advance_hold;               // set to skip the next step of the motor so it falls back
+
+        // feed hold, the moves are run on only some of the ticks so they follow the same path at a fraction of the speed
+        static const uint32_t HOLD_ONE= 1UL << 31;
+        volatile uint32_t hold_scale{HOLD_ONE};  // 1.31 fixed point, the ticks the moves advance by on each tick
+        uint32_t hold_phase{0};                  // 1.31 fixed point, when it gets to 1 the moves advance by a tick
+        int64_t hold_acceleration{0};            // 2.62 fixed point, the acceleration of the primary axis of hold_block per tick²
+        const Block *hold_block{nullptr};
+        uint8_t primary_index{0};                // the tick_info entry with the most steps in the current block
 
         struct {
             volatile bool running:1;
             uint8_t num_motors:4;
+            bool event_driven:1;
+            bool timer_stretched:1;
+            bool advance_busy:1;
+            volatile bool preparing:1;   // PendSV is getting the next block, the step ISR must not take blocks from the queue meanwhile
+            bool block_done:1;           // the current block finished while PendSV was preparing, it is given back on the next tick
+            volatile bool hold_request:1;
+            volatile bool drop_block:1;
         };
 };
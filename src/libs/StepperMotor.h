@@ -24,6 +24,11 @@ class StepperMotor  : public Module {
         inline void unstep() { step_pin.set(0); }
         // called from step ticker ISR
         inline void set_direction(bool f) { dir_pin.set(f); direction= f; }
+        // called from step ticker ISR when it sets the pins itself, along with those of the other motors on the same port
+        inline bool count_step() { current_position_steps += (direction?-1:1); return moving; }
+        inline void set_direction_flag(bool f) { direction= f; }
+        const Pin& get_step_pin() const { return step_pin; }
+        const Pin& get_dir_pin() const { return dir_pin; }
 
         void enable(bool state) { en_pin.set(!state); };
         bool is_enabled() const { return !en_pin.get(); };
@@ -28,6 +28,7 @@ class StreamOutput {
         virtual int _getc(void) { return 0; }
         virtual int puts(const char* str) = 0;
         virtual bool ready() { return true; };
+        virtual int rx_space() { return -1; } // free bytes in the receive buffer, -1 if it has none
 
         static NullStreamOutput NullStream;
 };
@@ -24,6 +24,7 @@
 #include "libs/Kernel.h"
 #include "libs/SerialMessage.h"
 #include "StreamOutputPool.h"
+#include "BinaryProtocol.h"
 
 #include "mbed.h"
 
@@ -36,8 +37,11 @@ USBSerial::USBSerial(USB *u): USBCDC(u), rxbuf(256), txbuf(128 + 8)
 {
     usb = u;
     nl_in_rx = 0;
+    frames_in_rx = 0;
+    frame_pos = frame_len = 0;
     attach = attached = false;
     flush_to_nl = false;
+    line_start = true;
     halt_flag = false;
     query_flag = false;
     last_char_was_cr = false;
@@ -80,9 +84,9 @@ int USBSerial::_getc()
     if (rxbuf.free() == MAX_PACKET_SIZE_EPBULK) {
         usb->endpointSetInterrupt(CDC_BulkOut.bEndpointAddress, true);
         iprintf("rxbuf has room for another packet, interrupt enabled\n");
-    } else if ((rxbuf.free() < MAX_PACKET_SIZE_EPBULK) && (nl_in_rx == 0)) {
+    } else if ((rxbuf.free() < MAX_PACKET_SIZE_EPBULK) && (nl_in_rx == 0) && (frames_in_rx == 0)) {
         // handle potential deadlock where a short line, and the beginning of a very long line are bundled in one usb packet
-        rxbuf.flush();
+        flush_rx();
         flush_to_nl = true;
 
         usb->endpointSetInterrupt(CDC_BulkOut.bEndpointAddress, true);
@@ -192,6 +196,29 @@ bool USBSerial::USBEvent_EPOut(uint8_t bEP, uint8_t bEPStatus)
     for (uint8_t i = 0; i < size; i++) {
         char b= c[i];
 
+        if(frame_pos > 0) {
+            // the rest of a binary frame goes in as it is, it is only counted once it is all here
+            rxbuf.queue(b);
+            if(++frame_pos == 3) {
+                // a bad length would never end or not fit, so just the header is passed on to be reported
+                frame_len = (c[i] <= BinaryProtocol::max_payload) ? c[i] + BinaryProtocol::overhead : 3;
+            }
+            if(frame_pos == frame_len) {
+                frame_pos = 0;
+                frames_in_rx++;
+                line_start = true;
+            }
+            continue;
+        }
+
+        // a frame only starts where a line could, so the sync byte can still be sent in a line
+        if(c[i] == BinaryProtocol::sync && line_start && THEKERNEL->is_binary_protocol_enabled() && !flush_to_nl) {
+            rxbuf.queue(b);
+            frame_pos = 1;
+            frame_len = 0;
+            continue;
+        }
+
         // handle backspace and delete by deleting the last character in the buffer if there is one
         if(b == 0x08 || b == 0x7F) {
             if(!rxbuf.isEmpty()) rxbuf.pop();
@@ -241,6 +268,7 @@ bool USBSerial::USBEvent_EPOut(uint8_t bEP, uint8_t bEPStatus)
         //     iprintf("\\x%02X", b);
         // }
 
+        line_start = (b == '\n' || b == '\r');
         if (b == '\n' || b == '\r') {
             if (flush_to_nl)
                 flush_to_nl = false;
@@ -249,7 +277,7 @@ bool USBSerial::USBEvent_EPOut(uint8_t bEP, uint8_t bEPStatus)
         } else if (rxbuf.isFull() && (nl_in_rx == 0)) {
             // to avoid a deadlock with very long lines, we must dump the buffer
             // and continue flushing to the next newline
-            rxbuf.flush();
+            flush_rx();
             flush_to_nl = true;
         }
     }
@@ -259,10 +287,10 @@ bool USBSerial::USBEvent_EPOut(uint8_t bEP, uint8_t bEPStatus)
         // if buffer is full, stall endpoint, do not accept more data
         r = false;
 
-        if (nl_in_rx == 0) {
+        if (nl_in_rx == 0 && frames_in_rx == 0) {
             // we have to check for long line deadlock here too
+            flush_rx();
             flush_to_nl = true;
-            rxbuf.flush();
 
             // and since our buffer is empty, we can accept more data
             r = true;
@@ -300,13 +328,12 @@ void USBSerial::on_idle(void *argument)
         } else {
             puts("HALTED, M999 or $X to exit HALT state\r\n");
         }
-        rxbuf.flush(); // flush the recieve buffer, hopefully upstream has stopped sending
-        nl_in_rx = 0;
+        flush_rx(); // flush the recieve buffer, hopefully upstream has stopped sending
     }
 
     if(query_flag) {
         query_flag = false;
-        puts(THEKERNEL->get_query_string().c_str());
+        puts(THEKERNEL->get_query_string(this).c_str());
     }
 
 }
@@ -331,15 +358,25 @@ void USBSerial::on_main_loop(void *argument)
             attached = false;
             THEKERNEL->streams->remove_stream(this);
             txbuf.flush();
-            rxbuf.flush();
-            nl_in_rx = 0;
+            flush_rx();
         }
     }
 
     // if we are in feed hold we do not process anything
     //if(THEKERNEL->get_feed_hold()) return;
 
+    // binary frames and lines come in the order they were sent, take all the frames that are at the front
+    uint8_t first;
+    while (frames_in_rx && available()) {
+        rxbuf.peek(&first, 0);
+        if (first != BinaryProtocol::sync) break;
+        read_frame();
+    }
+
     if (nl_in_rx) {
+        rxbuf.peek(&first, 0);
+        if (first == BinaryProtocol::sync) return; // the frame in front is still coming
+
         string received;
         while (available()) {
             char c = _getc();
@@ -357,6 +394,37 @@ void USBSerial::on_main_loop(void *argument)
     }
 }
 
+void USBSerial::read_frame()
+{
+    uint8_t frame[BinaryProtocol::max_payload + BinaryProtocol::overhead];
+    size_t len = 3;
+    rxbuf.peek(&frame[2], 2);
+    if (frame[2] <= BinaryProtocol::max_payload)
+        len = frame[2] + BinaryProtocol::overhead;
+    // not _getc() as the frame may have bytes that look like newlines
+    for (size_t i = 0; i < len; i++) {
+        rxbuf.dequeue(&frame[i]);
+    }
+    frames_in_rx--;
+    if (rxbuf.free() >= MAX_PACKET_SIZE_EPBULK)
+        usb->endpointSetInterrupt(CDC_BulkOut.bEndpointAddress, true);
+
+    if (!BinaryProtocol::handle_frame(frame, len, this)) {
+        // it has halted, the rest of what was sent is not wanted
+        flush_rx();
+    }
+}
+
+// drops everything received, with the lines and frames counted in it and the frame that is part way in
+void USBSerial::flush_rx()
+{
+    rxbuf.flush();
+    nl_in_rx = 0;
+    frames_in_rx = 0;
+    frame_pos = frame_len = 0;
+    line_start = true;
+}
+
 void USBSerial::on_attach()
 {
     attach = true;
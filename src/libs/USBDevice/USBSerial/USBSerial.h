@@ -41,6 +41,7 @@ public:
 
     uint8_t available();
     bool ready();
+    int rx_space() { return rxbuf.free(); }
 
     uint16_t writeBlock(const uint8_t * buf, uint16_t size);
 
@@ -63,10 +64,18 @@ protected:
 
     bool ensure_tx_space(int);
 
+    void read_frame();
+    void flush_rx();
+
     // keep track of number of newlines in the buffer
     // this makes it trivial to detect if there's a new line available
     volatile int nl_in_rx;
 
+    // the same for whole binary frames, and how far into the frame being received we are (0 if not in one)
+    volatile int frames_in_rx;
+    uint16_t frame_pos;
+    uint16_t frame_len;
+
 
     volatile struct {
         volatile bool attach:1;
@@ -74,6 +83,8 @@ protected:
         bool halt_flag:1;
         bool query_flag:1;
         bool last_char_was_cr:1;
+        // the next byte starts a line, only then can it be the sync byte of a binary frame
+        bool line_start:1;
         // if we receive a line that's longer than the buffer, to avoid a deadlock
         // we must flush the buffer.
         // then to avoid delivering the tail of a line to Smoothie we must keep
@@ -15,6 +15,7 @@
 #include <cstring>
 #include <stdio.h>
 #include <cstdlib>
+#include <ctype.h>
 
 #include "mbed.h"
 
@@ -243,6 +244,19 @@ vector<uint32_t> parse_number_list(const char *str, uint8_t radix)
     return r;
 }
 
+// decode pairs of hex digits "00407fbfff" into bytes, stops at the first pair that is not two hex digits or when buf is full,
+// returns the number of bytes so the first character not used is str[2 * n]
+size_t parse_hex_bytes(const char *str, uint8_t *buf, size_t maxlen)
+{
+    size_t n= 0;
+    while(n < maxlen && isxdigit(str[0]) && isxdigit(str[1])) {
+        char hex[3]= {str[0], str[1], 0};
+        buf[n++]= strtoul(hex, nullptr, 16);
+        str += 2;
+    }
+    return n;
+}
+
 int append_parameters(char *buf, std::vector<std::pair<char,float>> params, size_t bufsize)
 {
     size_t n= 0;
@@ -15,6 +15,7 @@ bool is_whitespace( int );
 std::vector<std::string> split(const char *str, char c = ',');
 std::vector<float> parse_number_list(const char *str);
 std::vector<uint32_t> parse_number_list(const char *str, uint8_t radix);
+size_t parse_hex_bytes(const char *str, uint8_t *buf, size_t maxlen);
 
 std::string remove_non_number( std::string str );
 
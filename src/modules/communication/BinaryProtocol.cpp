@@ -0,0 +1,103 @@
+/*
+      This file is part of Smoothie (http://smoothieware.org/). The motion control part is heavily based on Grbl (https://github.com/simen/grbl).
+      Smoothie is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+      Smoothie is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+      You should have received a copy of the GNU General Public License along with Smoothie. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "BinaryProtocol.h"
+#include "libs/Kernel.h"
+#include "StreamOutput.h"
+#include "Robot.h"
+#include "ActuatorCoordinates.h"
+
+#include <math.h>
+#include <string.h>
+
+uint16_t BinaryProtocol::crc16(const uint8_t *buf, size_t len)
+{
+    // a nibble at a time, the table is small enough to not matter and it is twice as fast as a bit at a time
+    static const uint16_t table[16]= {
+        0x0000, 0x1021, 0x2042, 0x3063, 0x4084, 0x50A5, 0x60C6, 0x70E7,
+        0x8108, 0x9129, 0xA14A, 0xB16B, 0xC18C, 0xD1AD, 0xE1CE, 0xF1EF
+    };
+    uint16_t crc= 0xFFFF;
+    for (size_t i = 0; i < len; ++i) {
+        crc= (crc << 4) ^ table[(crc >> 12) ^ (buf[i] >> 4)];
+        crc= (crc << 4) ^ table[(crc >> 12) ^ (buf[i] & 0x0F)];
+    }
+    return crc;
+}
+
+bool BinaryProtocol::handle_frame(const uint8_t *frame, size_t len, StreamOutput *stream)
+{
+    const char *error= nullptr;
+    if(len < overhead || frame[2] > max_payload || len != frame[2] + overhead) {
+        error= "Bad binary frame length";
+
+    }else if(crc16(&frame[1], len - 3) != (frame[len - 2] | (frame[len - 1] << 8))) {
+        error= "Bad binary frame crc";
+
+    }else if(THEKERNEL->is_halted()) {
+        // like gcode all moves are ignored until M999, the host was told when it halted
+        return true;
+
+    }else if(frame[1] == MOVE) {
+        error= move(&frame[3], frame[2]);
+
+    }else{
+        error= "Unknown binary frame";
+    }
+
+    if(error == nullptr) return true;
+
+    if(THEKERNEL->is_grbl_mode()) {
+        stream->printf("error:");
+    }else{
+        stream->printf("Error: ");
+    }
+    stream->printf("%s - reset or $X or M999 required\n", error);
+    THEKERNEL->call_event(ON_HALT, nullptr);
+    return false;
+}
+
+static int32_t get_int32(const uint8_t *p)
+{
+    int32_t v;
+    memcpy(&v, p, sizeof(v)); // little endian like the host sends it
+    return v;
+}
+
+const char *BinaryProtocol::move(const uint8_t *payload, uint8_t len)
+{
+    static const char *bad= "Bad binary move";
+    if(len < 2) return bad;
+    uint8_t flags= payload[0];
+    uint8_t axes= payload[1];
+    const uint8_t *p= &payload[2];
+    const uint8_t *end= payload + len;
+
+    float param[k_max_actuators];
+    for (size_t i = 0; i < k_max_actuators; ++i) {
+        param[i]= NAN;
+        if((axes & (1 << i)) == 0) continue;
+        if(p + 4 > end || i >= THEROBOT->get_number_registered_motors()) return bad;
+        param[i]= get_int32(p) / 10000.0F;
+        p += 4;
+    }
+
+    float rate= NAN, s= NAN;
+    if(flags & HAS_FEED) {
+        if(p + 4 > end) return bad;
+        rate= (uint32_t)get_int32(p) / 10000.0F;
+        p += 4;
+    }
+    if(flags & HAS_S) {
+        if(p + 4 > end) return bad;
+        s= (uint32_t)get_int32(p) / 10000.0F;
+        p += 4;
+    }
+    if(p != end || (axes >> k_max_actuators) != 0) return bad;
+
+    return THEROBOT->append_move(param, rate, s, flags & LINEAR);
+}
@@ -0,0 +1,44 @@
+/*
+      This file is part of Smoothie (http://smoothieware.org/). The motion control part is heavily based on Grbl (https://github.com/simen/grbl).
+      Smoothie is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+      Smoothie is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+      You should have received a copy of the GNU General Public License along with Smoothie. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+
+class StreamOutput;
+
+// Moves sent as binary frames instead of G0/G1 lines, so they need no float formatting on the host and no parsing here.
+// When enable_binary_protocol is set the USB serial takes a frame anywhere a line could start, so frames and gcode lines can be mixed.
+//
+// A frame is:  sync 0xFD | type | payload length | payload | crc16 low byte | crc16 high byte
+// the crc is CRC-16/CCITT-FALSE (poly 0x1021, init 0xFFFF) of the type, length and payload.
+//
+// A MOVE payload is, all little endian:
+//   flags   uint8   LINEAR for a G1 (the laser fires) otherwise a G0, HAS_FEED and HAS_S say if feed and s are there
+//   axes    uint8   bit n set if there is a target for axis n (X Y Z A B C)
+//   targets int32   one for each axis set, absolute in the current WCS in 1/10000 mm (machine coordinates for A B C)
+//   feed    uint32  in 1/10000 mm/min, modal like F
+//   s       uint32  in 1/10000, modal like S
+// moves get no ok, send a gcode line (eg M400) and wait for its ok to know they have all been taken.
+// A bad frame halts, as what comes after it can not be trusted.
+class BinaryProtocol {
+    public:
+        static const uint8_t sync= 0xFD;
+        static const uint8_t max_payload= 64;
+        static const uint8_t overhead= 5; // sync, type, length and crc
+        enum TYPE { MOVE= 1 };
+        enum MOVE_FLAGS { LINEAR= 0x01, HAS_FEED= 0x02, HAS_S= 0x04 };
+
+        static uint16_t crc16(const uint8_t *buf, size_t len);
+
+        // checks and does one whole frame, a frame with a bad length is passed as just its header, returns false if it was bad
+        static bool handle_frame(const uint8_t *frame, size_t len, StreamOutput *stream);
+
+    private:
+        static const char *move(const uint8_t *payload, uint8_t len); // returns the error or nullptr
+};
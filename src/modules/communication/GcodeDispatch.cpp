@@ -27,6 +27,10 @@
 #include "LPC17xx.h"
 #include "version.h"
 
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+
 #define panel_display_message_checksum CHECKSUM("display_message")
 #define panel_checksum             CHECKSUM("panel")
 
@@ -39,6 +43,42 @@ static bool is_allowed_mcode(int m) {
     return false;
 }
 
+// Scans a line that starts with a line number in one pass without making any copies, gets the line number and returns false if
+// there is a checksum that does not match, start is where the command starts after the line number and end is where the checksum
+// or a comment starts
+bool GcodeDispatch::scan_numbered_line(const string& line, int& ln, size_t& start, size_t& end)
+{
+    const char *s= line.c_str();
+    ln= strtol(s + 1, nullptr, 10);
+    start= strspn(s, "N0123456789.,- ");
+    end= line.size();
+
+    uint8_t cs= 0;
+    size_t i= 0;
+    for (; s[i] != '\0' && s[i] != '*'; ++i) {
+        cs ^= s[i];
+        if(i >= start && i < end && (s[i] == ';' || s[i] == '(')) end= i;
+    }
+
+    if(s[i] != '*') return true;
+    if(i < end) end= i;
+    return cs == strtol(s + i + 1, nullptr, 10);
+}
+
+// The ok for a line. With ok_buffer_space set it also has the free planner blocks and bytes free in the receive buffer, like the
+// Bf of grbl, so a host can count what it has sent and keep the buffers full instead of waiting for each ok.
+// Every ok goes through here so a host can always count on Bf being there, txt is anything that follows the ok on the same line
+static void send_ok(StreamOutput *stream, const char *eol= "\r\n", const char *txt= nullptr)
+{
+    const char *sep= txt == nullptr ? "" : " ";
+    if(txt == nullptr) txt= "";
+    if(THEKERNEL->is_ok_buffer_space()) {
+        stream->printf("ok Bf:%u,%d%s%s%s", THECONVEYOR->get_free_blocks(), stream->rx_space(), sep, txt, eol);
+    }else{
+        stream->printf("ok%s%s%s", sep, txt, eol);
+    }
+}
+
 GcodeDispatch::GcodeDispatch()
 {
     uploading = false;
@@ -63,7 +103,7 @@ void GcodeDispatch::on_console_line_received(void *line)
 
     // just reply ok to empty lines
     if(possible_command.empty()) {
-        new_message.stream->printf("ok\r\n");
+        send_ok(new_message.stream);
         return;
     }
 
@@ -83,52 +123,32 @@ try_again:
 
     if ( first_char == 'G' || first_char == 'M' || first_char == 'T' || first_char == 'S' || first_char == 'N' ) {
 
-        //Get linenumber
         if ( first_char == 'N' ) {
-            Gcode full_line = Gcode(possible_command, new_message.stream, false);
-            ln = (int) full_line.get_int('N');
-            int chksum = (int) full_line.get_int('*');
+            //Get linenumber and check the checksum
+            size_t start, end;
+            cs= scan_numbered_line(possible_command, ln, start, end) ? 0 : 1;
 
             //Catch message if it is M110: Set Current Line Number
-            if ( full_line.has_m ) {
-                if ( full_line.m == 110 ) {
-                    currentline = ln;
-                    new_message.stream->printf("ok\r\n");
-                    return;
-                }
+            if(possible_command.compare(start, 4, "M110") == 0 && !isdigit(possible_command[start + 4])) {
+                currentline = ln;
+                send_ok(new_message.stream);
+                return;
             }
 
-            //Strip checksum value from possible_command
-            size_t chkpos = possible_command.find_first_of("*");
-
-			//Calculate checksum
-            if ( chkpos != string::npos ) {
-				possible_command = possible_command.substr(0, chkpos);
-                for (auto c = possible_command.cbegin(); *c != '*' && c != possible_command.cend(); c++)
-                    cs = cs ^ *c;
-                cs &= 0xff;  // Defensive programming...
-                cs -= chksum;
-			}
-
-            //Strip line number value from possible_command
-			size_t lnsize = possible_command.find_first_not_of("N0123456789.,- ");
-			if(lnsize != string::npos) {
-				possible_command = possible_command.substr(lnsize);
-			}else{
-				// it is a blank line
-				possible_command.clear();
-			}
+            //Strip the line number, the checksum and any comment from possible_command
+            possible_command.erase(end);
+            possible_command.erase(0, start);
 
         } else {
             //Assume checks succeeded
             cs = 0x00;
             ln = currentline + 1;
-        }
 
-        //Remove comments
-        size_t comment = possible_command.find_first_of(";(");
-        if( comment != string::npos ) {
-            possible_command = possible_command.substr(0, comment);
+            //Remove comments
+            size_t comment = possible_command.find_first_of(";(");
+            if( comment != string::npos ) {
+                possible_command.erase(comment);
+            }
         }
 
         //If checksum passes then process message, else request resend
@@ -142,14 +162,9 @@ try_again:
             while(possible_command.size() > 0) {
                 // assumes G or M are always the first on the line
                 size_t nextcmd = possible_command.find_first_of("GM", 2);
-                string single_command;
-                if(nextcmd == string::npos) {
-                    single_command = possible_command;
-                    possible_command = "";
-                } else {
-                    single_command = possible_command.substr(0, nextcmd);
-                    possible_command = possible_command.substr(nextcmd);
-                }
+                // copied and removed in place so the strings keep the space they have, npos takes the rest of the line
+                single_command.assign(possible_command, 0, nextcmd);
+                possible_command.erase(0, nextcmd);
 
 
                 if(!uploading || upload_stream != new_message.stream) {
@@ -163,7 +178,7 @@ try_again:
                                 THEKERNEL->call_event(ON_HALT, (void *)1); // clears on_halt
                                 new_message.stream->printf("WARNING: After HALT you should HOME as position is currently unknown\n");
                             }
-                            new_message.stream->printf("ok\n");
+                            send_ok(new_message.stream, "\n");
                             delete gcode;
                             return;
 
@@ -189,7 +204,7 @@ try_again:
                                 // TODO it is really an error if the last is not G0 thru G3
                                 if(modal_group_1 > 3) {
                                     delete gcode;
-                                    new_message.stream->printf("ok - Invalid G53\r\n");
+                                    send_ok(new_message.stream, "\r\n", "- Invalid G53");
                                     return;
                                 }
                                 // use last G0 or G1
@@ -203,18 +218,20 @@ try_again:
                                 if(!gcode->has_g || gcode->g > 1) {
                                     // not G0 or G1 so ignore it as it is invalid
                                     delete gcode;
-                                    new_message.stream->printf("ok - Invalid G53\r\n");
+                                    send_ok(new_message.stream, "\r\n", "- Invalid G53");
                                     return;
                                 }
                             }
                             // makes it handle the parameters as a machine position
                             THEROBOT->next_command_is_MCS= true;
 
-                        } else if(gcode->g == 1) {
+                        } else if(gcode->g == 1 && !THEKERNEL->is_ok_buffer_space()) {
                             // optimize G1 to send ok immediately (one per line) before it is planned
+                            // not when the ok has the free blocks in it, that has to be sent once the move has taken its block.
+                            // a host that counts what it has sent does not wait for the ok to send more anyway
                             if(!sent_ok) {
                                 sent_ok= true;
-                                new_message.stream->printf("ok\n");
+                                send_ok(new_message.stream, "\n");
                             }
                         }
 
@@ -234,10 +251,11 @@ try_again:
                                 upload_fd = fopen(this->upload_filename.c_str(), "w");
                                 if(upload_fd != NULL) {
                                     this->uploading = true;
-                                    new_message.stream->printf("Writing to file: %s\r\nok\r\n", this->upload_filename.c_str());
+                                    new_message.stream->printf("Writing to file: %s\r\n", this->upload_filename.c_str());
                                 } else {
-                                    new_message.stream->printf("open failed, File: %s.\r\nok\r\n", this->upload_filename.c_str());
+                                    new_message.stream->printf("open failed, File: %s.\r\n", this->upload_filename.c_str());
                                 }
+                                send_ok(new_message.stream);
 
                                 // only save stuff from this stream
                                 upload_stream= new_message.stream;
@@ -263,7 +281,7 @@ try_again:
                                 // this is also handled out-of-band (it is now with ^X in the serial driver)
                                 // disables heaters and motors, ignores further incoming Gcode and clears block queue
                                 THEKERNEL->call_event(ON_HALT, nullptr);
-                                THEKERNEL->streams->printf("ok Emergency Stop Requested - reset or M999 required to exit HALT state\r\n");
+                                send_ok(THEKERNEL->streams, "\r\n", "Emergency Stop Requested - reset or M999 required to exit HALT state");
                                 delete gcode;
                                 return;
 
@@ -287,7 +305,9 @@ try_again:
                                 if(THEKERNEL->is_bad_mcu()) {
                                     new_message.stream->printf(", X-WARNING:deprecated_MCU");
                                 }
-                                new_message.stream->printf("\nok\n");
+                                new_message.stream->printf("\n");
+                                send_ok(new_message.stream, "\n");
+                                delete gcode;
                                 return;
                             }
 
@@ -296,7 +316,7 @@ try_again:
                                 string str= single_command.substr(4) + possible_command;
                                 PublicData::set_value( panel_checksum, panel_display_message_checksum, &str );
                                 delete gcode;
-                                new_message.stream->printf("ok\r\n");
+                                send_ok(new_message.stream);
                                 return;
                             }
 
@@ -320,7 +340,7 @@ try_again:
                                     }
                                 }
 
-                                new_message.stream->printf("ok\r\n");
+                                send_ok(new_message.stream);
                                 return;
                             }
 
@@ -340,7 +360,8 @@ try_again:
                                 delete gcode->stream;
                                 delete gcode;
                                 __enable_irq();
-                                new_message.stream->printf("Settings Stored to %s\r\nok\r\n", THEKERNEL->config_override_filename());
+                                new_message.stream->printf("Settings Stored to %s\r\n", THEKERNEL->config_override_filename());
+                                send_ok(new_message.stream);
                                 continue;
 
                             case 501: // load config override
@@ -353,13 +374,14 @@ try_again:
                                     SimpleShell::parse_command((gcode->m == 501) ? "load_command" : "save_command", arg, new_message.stream);
                                 }
                                 delete gcode;
-                                new_message.stream->printf("ok\r\n");
+                                send_ok(new_message.stream);
                                 return;
 
                             case 502: // M502 deletes config-override so everything defaults to what is in config
                                 remove(THEKERNEL->config_override_filename());
                                 delete gcode;
-                                new_message.stream->printf("config override file deleted %s, reboot needed\r\nok\r\n", THEKERNEL->config_override_filename());
+                                new_message.stream->printf("config override file deleted %s, reboot needed\r\n", THEKERNEL->config_override_filename());
+                                send_ok(new_message.stream);
                                 continue;
 
                             case 503: { // M503 display live settings and indicates if there is an override file
@@ -408,17 +430,17 @@ try_again:
                             new_message.stream->printf("\r\n");
 
                         if(!gcode->txt_after_ok.empty()) {
-                            new_message.stream->printf("ok %s\r\n", gcode->txt_after_ok.c_str());
+                            send_ok(new_message.stream, "\r\n", gcode->txt_after_ok.c_str());
                             gcode->txt_after_ok.clear();
 
                         } else {
                             if(THEKERNEL->is_ok_per_line() || THEKERNEL->is_grbl_mode()) {
                                 // only send ok once per line if this is a multi g code line send ok on the last one
                                 if(possible_command.empty())
-                                    new_message.stream->printf("ok\r\n");
+                                    send_ok(new_message.stream);
                             } else {
                                 // maybe should do the above for all hosts?
-                                new_message.stream->printf("ok\r\n");
+                                send_ok(new_message.stream);
                             }
                         }
                     }
@@ -434,13 +456,14 @@ try_again:
                         uploading = false;
                         upload_filename.clear();
                         upload_stream= nullptr;
-                        new_message.stream->printf("Done saving file.\r\nok\r\n");
+                        new_message.stream->printf("Done saving file.\r\n");
+                        send_ok(new_message.stream);
                         continue;
                     }
 
                     if(upload_fd == NULL) {
                         // error detected writing to file so discard everything until it stops
-                        new_message.stream->printf("ok\r\n");
+                        send_ok(new_message.stream);
                         continue;
                     }
 
@@ -453,7 +476,7 @@ try_again:
                         continue;
 
                     } else {
-                         new_message.stream->printf("ok\r\n");
+                        send_ok(new_message.stream);
                         //printf("uploading file write ok\n");
                     }
                 }
@@ -466,7 +489,7 @@ try_again:
 
     } else if ( first_char == ';' || first_char == '(' || first_char == '\n' || first_char == '\r' ) {
         // Ignore comments and blank lines
-        new_message.stream->printf("ok\n");
+        send_ok(new_message.stream, "\n");
 
     } else if( (n=possible_command.find_first_of("XYZF")) == 0 || (first_char == ' ' && n != string::npos) ) {
         // handle pycam syntax, use last modal group 1 command and resubmit if an X Y Z or F is found on its own line
@@ -484,7 +507,7 @@ try_again:
 
     } else {
         // an uppercase non command word on its own (except XYZF) just returns ok, we could add an error but no hosts expect that.
-        new_message.stream->printf("ok - ignored\n");
+        send_ok(new_message.stream, "\n", "- ignored");
     }
 }
 
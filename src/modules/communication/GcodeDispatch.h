@@ -23,9 +23,14 @@ public:
     virtual void on_console_line_received(void *line);
 
     uint8_t get_modal_command() const { return modal_group_1<4 ? modal_group_1 : 0; }
+
+    // gets the line number of a line starting with N, start and end are where the command is, false if the checksum is bad
+    static bool scan_numbered_line(const std::string& line, int& ln, size_t& start, size_t& end);
+
 private:
     int currentline;
     std::string upload_filename;
+    std::string single_command; // kept between lines so it does not need new space for each one
     FILE *upload_fd;
     StreamOutput* upload_stream{nullptr};
     uint8_t modal_group_1;
@@ -70,7 +70,7 @@ void SerialConsole::on_idle(void * argument)
 {
     if(query_flag) {
         query_flag= false;
-        puts(THEKERNEL->get_query_string().c_str());
+        puts(THEKERNEL->get_query_string(this).c_str());
     }
     if(halt_flag) {
         halt_flag= false;
@@ -33,6 +33,7 @@ class SerialConsole : public Module, public StreamOutput {
         int _putc(int c);
         int _getc(void);
         int puts(const char*);
+        int rx_space() { return buffer.capacity() - buffer.size(); }
 
         //string receive_buffer;                 // Received chars are stored here until a newline character is received
         //vector<std::string> received_lines;    // Received lines are stored here until they are requested
@@ -10,13 +10,45 @@
 #include "libs/StreamOutput.h"
 #include "utils.h"
 #include <stdlib.h>
+#include <string.h>
 #include <algorithm>
 
+// the dispatcher only has one gcode at a time, and one more may be made while that is being handled
+static const int pool_slots= 2;
+static union {
+    char mem[sizeof(Gcode)];
+    double align;
+} pool[pool_slots];
+static uint8_t pool_used= 0;
+
+void *Gcode::operator new(size_t size)
+{
+    for (int i = 0; i < pool_slots; ++i) {
+        if((pool_used & (1 << i)) == 0) {
+            pool_used |= (1 << i);
+            return &pool[i];
+        }
+    }
+    return ::operator new(size);
+}
+
+void Gcode::operator delete(void *p)
+{
+    for (int i = 0; i < pool_slots; ++i) {
+        if(p == &pool[i]) {
+            pool_used &= ~(1 << i);
+            return;
+        }
+    }
+    ::operator delete(p);
+}
+
 // This is a gcode object. It represents a GCode string/command, and caches some important values about that command for the sake of performance.
 // It gets passed around in events, and attached to the queue ( that'll change )
 Gcode::Gcode(const string &command, StreamOutput *stream, bool strip)
 {
-    this->command= strdup(command.c_str());
+    this->command= buffer;
+    set_command(command.c_str());
     this->m= 0;
     this->g= 0;
     this->subcode= 0;
@@ -25,19 +57,23 @@ Gcode::Gcode(const string &command, StreamOutput *stream, bool strip)
     this->stream= stream;
     prepare_cached_values(strip);
     this->stripped= strip;
+    parse_args();
 }
 
 Gcode::~Gcode()
 {
-    if(command != nullptr) {
-        // TODO we can reference count this so we share copies, may save more ram than the extra count we need to store
+    if(command != buffer) {
         free(command);
     }
 }
 
 Gcode::Gcode(const Gcode &to_copy)
 {
-    this->command               = strdup(to_copy.command); // TODO we can reference count this so we share copies, may save more ram than the extra count we need to store
+    this->command               = buffer;
+    set_command(to_copy.command);
+    this->letters               = to_copy.letters;
+    memcpy(this->values, to_copy.values, sizeof(values));
+    memcpy(this->offsets, to_copy.offsets, sizeof(offsets));
     this->has_m                 = to_copy.has_m;
     this->has_g                 = to_copy.has_g;
     this->m                     = to_copy.m;
@@ -45,6 +81,7 @@ Gcode::Gcode(const Gcode &to_copy)
     this->subcode               = to_copy.subcode;
     this->add_nl                = to_copy.add_nl;
     this->is_error              = to_copy.is_error;
+    this->stripped              = to_copy.stripped;
     this->stream                = to_copy.stream;
     this->txt_after_ok.assign( to_copy.txt_after_ok );
 }
@@ -52,7 +89,10 @@ Gcode::Gcode(const Gcode &to_copy)
 Gcode &Gcode::operator= (const Gcode &to_copy)
 {
     if( this != &to_copy ) {
-        this->command               = strdup(to_copy.command); // TODO we can reference count this so we share copies, may save more ram than the extra count we need to store
+        set_command(to_copy.command);
+        this->letters               = to_copy.letters;
+        memcpy(this->values, to_copy.values, sizeof(values));
+        memcpy(this->offsets, to_copy.offsets, sizeof(offsets));
         this->has_m                 = to_copy.has_m;
         this->has_g                 = to_copy.has_g;
         this->m                     = to_copy.m;
@@ -60,27 +100,57 @@ Gcode &Gcode::operator= (const Gcode &to_copy)
         this->subcode               = to_copy.subcode;
         this->add_nl                = to_copy.add_nl;
         this->is_error              = to_copy.is_error;
+        this->stripped              = to_copy.stripped;
         this->stream                = to_copy.stream;
         this->txt_after_ok.assign( to_copy.txt_after_ok );
     }
     return *this;
 }
 
+// copies the text into the buffer, or onto the heap if it does not fit
+void Gcode::set_command(const char *s)
+{
+    size_t n= strlen(s) + 1;
+    if(command != buffer) free(command);
+    command= (n <= sizeof(buffer)) ? buffer : (char *)malloc(n);
+    memcpy(command, s, n);
+}
 
-// Whether or not a Gcode has a letter
-bool Gcode::has_letter( char letter ) const
+// parse the arguments into the table, has_letter() is true for any occurrence of a letter, as it always was
+void Gcode::parse_args()
 {
-    for (size_t i = 0; i < strlen(this->command); ++i) {
-        if( command[i] == letter ) {
-            return true;
+    letters= 0;
+    memset(offsets, 0, sizeof(offsets));
+    for (const char *cs = command; *cs; cs++) {
+        if(!is_arg(*cs)) continue;
+        int i= *cs - 'A';
+        letters |= 1UL << i;
+        if(offsets[i] != 0) continue;
+
+        char *cn;
+        float r= strtof(cs + 1, &cn);
+        if(cn > cs + 1) {
+            values[i]= r;
+            offsets[i]= cs + 1 - command;
         }
     }
-    return false;
+}
+
+// Whether or not a Gcode has a letter
+bool Gcode::has_letter( char letter ) const
+{
+    if(is_arg(letter)) return (letters & (1UL << (letter - 'A'))) != 0;
+    return letter != '\0' && strchr(command, letter) != nullptr;
 }
 
 // Retrieve the value for a given letter
 float Gcode::get_value( char letter, char **ptr ) const
 {
+    if(ptr == nullptr && is_arg(letter)) {
+        int i= letter - 'A';
+        return offsets[i] != 0 ? values[i] : 0;
+    }
+
     const char *cs = command;
     char *cn = NULL;
     for (; *cs; cs++) {
@@ -98,6 +168,11 @@ float Gcode::get_value( char letter, char **ptr ) const
 
 int Gcode::get_int( char letter, char **ptr ) const
 {
+    if(ptr == nullptr && is_arg(letter)) {
+        int i= letter - 'A';
+        return offsets[i] != 0 ? strtol(command + offsets[i], nullptr, 10) : 0;
+    }
+
     const char *cs = command;
     char *cn = NULL;
     for (; *cs; cs++) {
@@ -115,6 +190,11 @@ int Gcode::get_int( char letter, char **ptr ) const
 
 uint32_t Gcode::get_uint( char letter, char **ptr ) const
 {
+    if(ptr == nullptr && is_arg(letter)) {
+        int i= letter - 'A';
+        return offsets[i] != 0 ? strtoul(command + offsets[i], nullptr, 10) : 0;
+    }
+
     const char *cs = command;
     char *cn = NULL;
     for (; *cs; cs++) {
@@ -133,7 +213,7 @@ uint32_t Gcode::get_uint( char letter, char **ptr ) const
 int Gcode::get_num_args() const
 {
     int count = 0;
-    for(size_t i = stripped?0:1; i < strlen(command); i++) {
+    for(size_t i = stripped?0:1; command[i] != '\0'; i++) {
         if( this->command[i] >= 'A' && this->command[i] <= 'Z' ) {
             if(this->command[i] == 'T') continue;
             count++;
@@ -145,7 +225,7 @@ int Gcode::get_num_args() const
 std::map<char,float> Gcode::get_args() const
 {
     std::map<char,float> m;
-    for(size_t i = stripped?0:1; i < strlen(command); i++) {
+    for(size_t i = stripped?0:1; command[i] != '\0'; i++) {
         char c= this->command[i];
         if( c >= 'A' && c <= 'Z' ) {
             if(c == 'T') continue;
@@ -158,7 +238,7 @@ std::map<char,float> Gcode::get_args() const
 std::map<char,int> Gcode::get_args_int() const
 {
     std::map<char,int> m;
-    for(size_t i = stripped?0:1; i < strlen(command); i++) {
+    for(size_t i = stripped?0:1; command[i] != '\0'; i++) {
         char c= this->command[i];
         if( c >= 'A' && c <= 'Z' ) {
             if(c == 'T') continue;
@@ -171,8 +251,9 @@ std::map<char,int> Gcode::get_args_int() const
 // Cache some of this command's properties, so we don't have to parse the string every time we want to look at them
 void Gcode::prepare_cached_values(bool strip)
 {
+    // the arguments are not parsed yet
     char *p= nullptr;
-    if( this->has_letter('G') ) {
+    if( strchr(command, 'G') != nullptr ) {
         this->has_g = true;
         this->g = this->get_int('G', &p);
 
@@ -180,7 +261,7 @@ void Gcode::prepare_cached_values(bool strip)
         this->has_g = false;
     }
 
-    if( this->has_letter('M') ) {
+    if( strchr(command, 'M') != nullptr ) {
         this->has_m = true;
         this->m = this->get_int('M', &p);
 
@@ -202,9 +283,7 @@ void Gcode::prepare_cached_values(bool strip)
 
     // remove the Gxxx or Mxxx from string
     if (p != nullptr) {
-        char *n= strdup(p); // create new string starting at end of the numeric value
-        free(command);
-        command= n;
+        memmove(command, p, strlen(p) + 1); // move the rest of the string down to after the numeric value
     }
 }
 
@@ -234,9 +313,8 @@ void Gcode::strip_parameters()
         // strip whitespace to save even more, this causes problems so don't do it
         //newcmd.erase(std::remove_if(newcmd.begin(), newcmd.end(), ::isspace), newcmd.end());
 
-        // release the old one
-        free(command);
         // copy the new shortened one
-        command= strdup(newcmd.c_str());
+        set_command(newcmd.c_str());
+        parse_args();
     }
 }
@@ -10,6 +10,7 @@
 #define GCODE_H
 #include <string>
 #include <map>
+#include <stdint.h>
 
 using std::string;
 
@@ -23,6 +24,10 @@ class Gcode {
         Gcode& operator= (const Gcode& to_copy);
         ~Gcode();
 
+        // gcodes come from a small fixed pool so streaming does not churn the heap, if that is all in use they come from the heap
+        static void *operator new(size_t size);
+        static void operator delete(void *p);
+
         const char* get_command() const { return command; }
         bool has_letter ( char letter ) const;
         float get_value ( char letter, char **ptr= nullptr ) const;
@@ -51,6 +56,18 @@ class Gcode {
 
     private:
         void prepare_cached_values(bool strip=true);
+        void set_command(const char *s);
+        void parse_args();
+        static bool is_arg(char letter) { return letter >= 'A' && letter <= 'Z'; }
+
+        // the text is kept in the object unless it is too long to fit, then it goes on the heap
         char *command;
+        char buffer[64];
+
+        // the arguments are parsed once, for each letter A-Z the value of its first occurrence that is followed by a number
+        // and where that number is in command, 0 if there is none
+        uint32_t letters; // bit set for each letter A-Z that is in command
+        float values[26];
+        uint16_t offsets[26];
 };
 #endif
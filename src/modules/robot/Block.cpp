@@ -10,8 +10,10 @@
 #include "libs/nuts_bolts.h"
 #include <cmath>
 #include <string>
+#include <stdlib.h>
 #include "Block.h"
 #include "Planner.h"
+#include "InputShaper.h"
 #include "Conveyor.h"
 #include "Gcode.h"
 #include "libs/StreamOutputPool.h"
@@ -27,6 +29,7 @@ using std::string;
 
 uint8_t Block::n_actuators= 0;
 double Block::fp_scale= 0;
+MemoryPool *Block::tick_pool= nullptr;
 
 // A block represents a movement, it's length for each stepper motor, and the corresponding acceleration curves.
 // It's stacked on a queue, and that queue is then executed in order, to move the motors.
@@ -39,10 +42,29 @@ Block::Block()
     clear();
 }
 
-void Block::init(uint8_t n)
+// returns false if there is not enough memory for the tick info of a queue this long
+bool Block::init(uint8_t n, uint16_t queue_size)
 {
     n_actuators= n;
     fp_scale= (double)STEPTICKER_FPSCALE / pow((double)STEP_TICKER_FREQUENCY, 2.0); // we scale up by fixed point offset first to avoid tiny values
+
+    // The tick info is only allocated for the motors that move in each block, so the pool is sized for up to 4 moving motors
+    // (XYZE) per queued block. If it runs out (more motors, S-curves or input shaping) the planner waits for blocks to finish, which just shortens the lookahead.
+    // It always holds at least two blocks that move every motor, and one raster line.
+    const uint32_t entry_size= sizeof(tickinfo_t) + sizeof(rampinfo_t);
+    uint32_t size= queue_size * (std::min<uint32_t>(n, 4) * entry_size + sizeof(speedinfo_t) + 8);
+    size= std::max<uint32_t>(size, 2 * (n * (entry_size + sizeof(jerkinfo_t)) + sizeof(speedinfo_t) + 8));
+    size += max_raster_pixels;
+    size= std::min<uint32_t>(size, 0xFFFF);
+
+    // the block queue is in AHB0 so use AHB1 if there is room, then the heap
+    void *v= AHB1.alloc(size);
+    if(v == nullptr) v= AHB0.alloc(size);
+    if(v == nullptr) v= malloc(size);
+    if(v == nullptr) return false;
+
+    tick_pool= new MemoryPool(v, size);
+    return true;
 }
 
 void Block::clear()
@@ -58,6 +80,7 @@ void Block::clear()
     entry_speed         = 0.0F;
     exit_speed          = 0.0F;
     acceleration        = 100.0F; // we don't want to get divide by zeroes if this is not set
+    jerk                = 0.0F;
     initial_rate        = 0.0F;
     accelerate_until    = 0;
     decelerate_after    = 0;
@@ -65,30 +88,111 @@ void Block::clear()
     recalculate_flag    = false;
     nominal_length_flag = false;
     max_entry_speed     = 0.0F;
+    max_junction_speed  = 0.0F;
     is_ticking          = false;
     is_g123             = false;
     locked              = false;
+    has_speed_info      = false;
     s_value             = 0.0F;
 
     total_move_ticks= 0;
-    if(tick_info == nullptr) {
-        // we create this once for this block
-        tick_info= new tickinfo_t[n_actuators]; //(tickinfo_t *)malloc(sizeof(tickinfo_t) * n_actuators);
-        if(tick_info == nullptr) {
-            // if we ran out of memory in AHB0 just stop here
-            __debugbreak();
-        }
+    queued_ticks= 0;
+    next_accel_event= 0;
+    n_active= 0;
+    arc_steps= 0;
+    raster_pixels= 0;
+    accel_jerk_ticks= 0;
+    decel_jerk_ticks= 0;
+    jerk_phase= NO_JERK;
+    next_jerk_event= UINT32_MAX;
+    shaper= nullptr;
+    shaper_impulse= 0;
+    shaper_fall_impulse= 0;
+
+    // give the tick info back to the pool, this is never done in the ISR
+    if(tick_info != nullptr) {
+        tick_pool->dealloc(tick_info);
+        tick_info= nullptr;
     }
+}
+
+// find the motors that move in this block and get tick info for just those from the pool
+// for an arc the plane axes are replaced by a single entry for the path along the arc
+// returns false if the pool does not have room for it yet
+bool Block::allocate_tick_info(const ArcPath *arc, uint16_t raster_pixels, bool speed_override)
+{
+    uint8_t n= 0;
+    for (uint8_t m = 0; m < n_actuators; m++) {
+        if(arc != nullptr && (m == arc->axis[0] || m == arc->axis[1])) continue;
+        if(this->steps[m] != 0) this->active_motors[n++]= m;
+    }
+    if(arc != nullptr) this->active_motors[n++]= ARC_PATH;
+
+    size_t size= n * (sizeof(tickinfo_t) + sizeof(rampinfo_t));
+    if(this->jerk > 0.0F || this->shaper != nullptr) size += n * sizeof(jerkinfo_t);
+    if(this->shaper != nullptr) size += 4 * sizeof(uint32_t); // the shaper starts
+    size_t tail_offset= size;
+    if(speed_override) size += sizeof(speedinfo_t);
+    if(arc != nullptr) size += sizeof(arcinfo_t);
+    size_t raster_offset= size;
+    size += raster_pixels;
+
+    void *v= tick_pool->alloc(size);
+    if(v == nullptr) return false;
+
+    this->n_active= n;
+    this->tick_info= (tickinfo_t *)v;
+    this->tail_offset= tail_offset;
+    this->raster_offset= raster_offset;
+    this->has_speed_info= speed_override;
+    this->raster_pixels= raster_pixels;
+    return true;
+}
+
+// split a coefficient into a signed 1.31 mantissa and a shift so the step ticker can multiply a 32.32 fixed point position by it
+static void fixed_coefficient(double c, int32_t& m, uint8_t& shift)
+{
+    int e;
+    double f= frexp(c, &e); // c= f * 2^e with 0.5 <= |f| < 1
+    int64_t mm= llround(f * 2147483648.0);
+    if(mm >= 2147483648LL || mm <= -2147483648LL) { mm /= 2; ++e; }
+    int s= 31 - e;
+    if(c == 0 || s > 94) { m= 0; shift= 32; return; } // too small to ever change the position
+    m= mm;
+    shift= std::max(s, 32); // Robot only uses an arc if the radius is several steps so the coefficients are always small
+}
 
-    for(int i = 0; i < n_actuators; ++i) {
-        tick_info[i].steps_per_tick= 0;
-        tick_info[i].counter= 0;
-        tick_info[i].acceleration_change= 0;
-        tick_info[i].deceleration_change= 0;
-        tick_info[i].plateau_rate= 0;
-        tick_info[i].steps_to_move= 0;
-        tick_info[i].step_count= 0;
-        tick_info[i].next_accel_event= 0;
+// setup the path along the arc, start_steps is where the plane axes are at the start of the block
+void Block::setup_arc(const ArcPath& arc, const int32_t start_steps[2], const float steps_per_mm[2])
+{
+    const double one= 4294967296.0; // 1.0 in 32.32 fixed point
+
+    // the path is stepped finely enough that neither plane axis can need more than one step per path step
+    double radius= hypot(arc.start[0], arc.start[1]);
+    double path_steps_per_mm= std::max(steps_per_mm[0], steps_per_mm[1]);
+    this->arc_steps= std::max(1.0, ceil(fabs(arc.angle) * radius * path_steps_per_mm));
+
+    // rotating the position in mm by the angle per path step, in step units of each axis
+    // if the end is not quite the same radius (rounding in the gcode) the radius is also scaled by k each step so it is a slight spiral
+    double a= (double)arc.angle / this->arc_steps;
+    double k= pow(hypot(arc.end[0], arc.end[1]) / radius, 1.0 / this->arc_steps);
+    double s= k * sin(a);
+    arcinfo_t *arc_info= this->arc_info();
+    fixed_coefficient((1 - k) + k * 2 * pow(sin(a / 2), 2), arc_info->cos_m, arc_info->cos_shift); // 1 - k*cos(a)
+    fixed_coefficient(s * steps_per_mm[0] / steps_per_mm[1], arc_info->sin_m[0], arc_info->sin_shift[0]);
+    fixed_coefficient(s * steps_per_mm[1] / steps_per_mm[0], arc_info->sin_m[1], arc_info->sin_shift[1]);
+
+    for (int i = 0; i < 2; ++i) {
+        uint8_t m= arc.axis[i];
+        double center= (double)arc.center[i] * steps_per_mm[i];
+        arc_info->motor[i]= m;
+        arc_info->forward[i]= !this->direction_bits[m];
+        arc_info->steps_to_move[i]= this->steps[m];
+        arc_info->step_count[i]= 0;
+        arc_info->pos[i]= llround((double)arc.start[i] * steps_per_mm[i] * one);
+        arc_info->end[i]= llround((double)arc.end[i] * steps_per_mm[i] * one);
+        // the motor is at the nearest step to its position so the next step is half a step away
+        arc_info->next[i]= llround((start_steps[i] + (arc_info->forward[i] ? 0.5 : -0.5) - center) * one);
     }
 }
 
@@ -144,37 +248,73 @@ void Block::calculate_trapezoid( float entryspeed, float exitspeed )
     // This is a simplification to get rid of rate_delta and get the steps/s² accel directly from the mm/s² accel
     float acceleration_per_second = (this->acceleration * this->steps_event_count) / this->millimeters;
 
-    float maximum_possible_rate = sqrtf( ( this->steps_event_count * acceleration_per_second ) + ( ( powf(initial_rate, 2) + powf(final_rate, 2) ) / 2.0F ) );
+    float time_to_accelerate, time_to_decelerate;
+    float plateau_time = 0;
+
+    if(this->jerk > 0.0F || this->shaper != nullptr) {
+        // an S-curve or shaped ramp takes longer than the acceleration alone would, see ramp_time(), so find the fastest speed the ramps
+        // to and from it still fit in the block, by bisection as there is no closed form for the two ramps together
+        float low = std::max(entryspeed, exitspeed), high = this->nominal_speed;
+        float speed = high;
+        if(ramp_distance(entryspeed, high) + ramp_distance(high, exitspeed) > this->millimeters) {
+            speed = low;
+            for (int i = 0; i < 16; ++i) {
+                float mid = (low + high) / 2.0F;
+                if(ramp_distance(entryspeed, mid) + ramp_distance(mid, exitspeed) <= this->millimeters) low = speed = mid;
+                else high = mid;
+            }
+        }
+        this->maximum_rate = this->nominal_rate * (speed / this->nominal_speed);
+
+        time_to_accelerate = ramp_time(speed - entryspeed);
+        time_to_decelerate = ramp_time(speed - exitspeed);
+        float ramps_distance = ramp_distance(entryspeed, speed) + ramp_distance(speed, exitspeed);
+        if(ramps_distance > this->millimeters) {
+            // the planner only makes sure the speed changes fit at the acceleration, a block shorter than the extra time the jerk or the
+            // shaper takes needs at cruising speed cannot fit it, so shorten just the extra time and keep the acceleration at the setting
+            float accel_time = (speed - entryspeed) / this->acceleration;
+            float decel_time = (speed - exitspeed) / this->acceleration;
+            float plain_distance = (entryspeed + speed) / 2.0F * accel_time + (speed + exitspeed) / 2.0F * decel_time;
+            float squeeze = (plain_distance < this->millimeters) ? (this->millimeters - plain_distance) / (ramps_distance - plain_distance) : 0.0F;
+            time_to_accelerate = accel_time + (time_to_accelerate - accel_time) * squeeze;
+            time_to_decelerate = decel_time + (time_to_decelerate - decel_time) * squeeze;
+        } else if(speed > 0.0F) {
+            plateau_time = (this->millimeters - ramps_distance) / speed;
+        }
 
-    //printf("id %d: acceleration_per_second: %f, maximum_possible_rate: %f steps/sec, %f mm/sec\n", this->id, acceleration_per_second, maximum_possible_rate, maximum_possible_rate/100);
+    } else {
+        float maximum_possible_rate = sqrtf( ( this->steps_event_count * acceleration_per_second ) + ( ( powf(initial_rate, 2) + powf(final_rate, 2) ) / 2.0F ) );
 
-    // Now this is the maximum rate we'll achieve this move, either because
-    // it's the higher we can achieve, or because it's the higher we are
-    // allowed to achieve
-    this->maximum_rate = std::min(maximum_possible_rate, this->nominal_rate);
+        //printf("id %d: acceleration_per_second: %f, maximum_possible_rate: %f steps/sec, %f mm/sec\n", this->id, acceleration_per_second, maximum_possible_rate, maximum_possible_rate/100);
 
-    // Now figure out how long it takes to accelerate in seconds
-    float time_to_accelerate = ( this->maximum_rate - initial_rate ) / acceleration_per_second;
+        // Now this is the maximum rate we'll achieve this move, either because
+        // it's the higher we can achieve, or because it's the higher we are
+        // allowed to achieve
+        this->maximum_rate = std::min(maximum_possible_rate, this->nominal_rate);
 
-    // Now figure out how long it takes to decelerate
-    float time_to_decelerate = ( final_rate -  this->maximum_rate ) / -acceleration_per_second;
+        // Now figure out how long it takes to accelerate in seconds
+        // when the speed change takes the whole block rounding can leave these a tiny bit negative
+        time_to_accelerate = std::max(0.0F, ( this->maximum_rate - initial_rate ) / acceleration_per_second);
 
-    // Now we know how long it takes to accelerate and decelerate, but we must
-    // also know how long the entire move takes so we can figure out how long
-    // is the plateau if there is one
-    float plateau_time = 0;
+        // Now figure out how long it takes to decelerate
+        time_to_decelerate = std::max(0.0F, ( final_rate -  this->maximum_rate ) / -acceleration_per_second);
 
-    // Only if there is actually a plateau ( we are limited by nominal_rate )
-    if(maximum_possible_rate > this->nominal_rate) {
-        // Figure out the acceleration and deceleration distances ( in steps )
-        float acceleration_distance = ( ( initial_rate + this->maximum_rate ) / 2.0F ) * time_to_accelerate;
-        float deceleration_distance = ( ( this->maximum_rate + final_rate ) / 2.0F ) * time_to_decelerate;
+        // Now we know how long it takes to accelerate and decelerate, but we must
+        // also know how long the entire move takes so we can figure out how long
+        // is the plateau if there is one
 
-        // Figure out the plateau steps
-        float plateau_distance = this->steps_event_count - acceleration_distance - deceleration_distance;
+        // Only if there is actually a plateau ( we are limited by nominal_rate )
+        if(maximum_possible_rate > this->nominal_rate) {
+            // Figure out the acceleration and deceleration distances ( in steps )
+            float acceleration_distance = ( ( initial_rate + this->maximum_rate ) / 2.0F ) * time_to_accelerate;
+            float deceleration_distance = ( ( this->maximum_rate + final_rate ) / 2.0F ) * time_to_decelerate;
 
-        // Figure out the plateau time in seconds
-        plateau_time = plateau_distance / this->maximum_rate;
+            // Figure out the plateau steps
+            float plateau_distance = this->steps_event_count - acceleration_distance - deceleration_distance;
+
+            // Figure out the plateau time in seconds
+            plateau_time = plateau_distance / this->maximum_rate;
+        }
     }
 
     // Figure out how long the move takes total ( in seconds )
@@ -193,6 +333,12 @@ void Block::calculate_trapezoid( float entryspeed, float exitspeed )
     uint32_t acceleration_ticks = floorf( time_to_accelerate * STEP_TICKER_FREQUENCY );
     uint32_t deceleration_ticks = floorf( time_to_decelerate * STEP_TICKER_FREQUENCY );
     uint32_t total_move_ticks   = floorf( total_move_time    * STEP_TICKER_FREQUENCY );
+    if(this->jerk > 0.0F || this->shaper != nullptr) {
+        // rounding an S-curve or shaped ramp down would take its peak acceleration over the setting, so round up and make room for it
+        acceleration_ticks = ceilf( time_to_accelerate * STEP_TICKER_FREQUENCY );
+        deceleration_ticks = ceilf( time_to_decelerate * STEP_TICKER_FREQUENCY );
+        total_move_ticks = std::max(total_move_ticks, acceleration_ticks + deceleration_ticks);
+    }
 
     // Now deduce the plateau time for those new values expressed in tick
     //uint32_t plateau_ticks = total_move_ticks - acceleration_ticks - deceleration_ticks;
@@ -224,11 +370,82 @@ void Block::calculate_trapezoid( float entryspeed, float exitspeed )
     this->locked= false;
 }
 
+// the time in seconds it takes to change the speed by the given mm/s, an S-curve or shaped ramp takes longer than the
+// acceleration alone would so that the jerk or the shaper never has to take the acceleration over the setting
+float Block::ramp_time(float speed_change) const
+{
+    if(speed_change <= 0.0F) return 0.0F;
+    float t = speed_change / this->acceleration;
+
+    if(this->shaper != nullptr) {
+        // the acceleration of the trapezoid ramp convolved with the shaper, its impulses add up to 1 so it never goes over
+        // the acceleration of the trapezoid but the ramp takes the time the shaper uses up longer, see shaper_ramp()
+        return t + shaper_span(this->shaper->duration) / STEP_TICKER_FREQUENCY;
+    }
+    if(this->jerk <= 0.0F) return t;
+
+    // the jerk takes tj to get to the full acceleration and as long to get back to zero, a smaller speed change never gets there
+    float tj = this->acceleration / this->jerk;
+    return (t <= tj) ? 2.0F * sqrtf(speed_change / this->jerk) : t + tj;
+}
+
+// the distance in mm a ramp between the two speeds takes, the ramps are symmetrical so it is the average speed for the ramp time
+float Block::ramp_distance(float start_speed, float end_speed) const
+{
+    return (start_speed + end_speed) / 2.0F * ramp_time(fabsf(end_speed - start_speed));
+}
+
 // Calculates the maximum allowable speed at this point when you must be able to reach target_velocity using the
 // acceleration within the allotted distance.
-float Block::max_allowable_speed(float acceleration, float target_velocity, float distance)
+float Block::max_allowable_speed(float target_velocity, float distance) const
 {
-    return sqrtf(target_velocity * target_velocity - 2.0F * acceleration * distance);
+    float a = this->acceleration;
+    if(this->jerk <= 0.0F && this->shaper == nullptr) return sqrtf(target_velocity * target_velocity + 2.0F * a * distance);
+    if(distance <= 0.0F) return target_velocity;
+
+    float vt = target_velocity;
+    if(this->shaper != nullptr) {
+        // the ramp takes dv/a + ts, solve (2*vt + dv)/2 * (dv/a + ts) = distance for dv, there is no room for any speed change
+        // at all if the block is shorter than vt*ts
+        float ts = shaper_span(this->shaper->duration) / STEP_TICKER_FREQUENCY;
+        float b = vt + a * ts / 2.0F;
+        return vt + std::max(0.0F, sqrtf(std::max(0.0F, b * b + 2.0F * a * (distance - vt * ts))) - b);
+    }
+
+    float tj = a / this->jerk;
+    if(distance < (2.0F * vt + a * tj) * tj) {
+        // too short to get to the full acceleration, a ramp of 2u takes (2*vt + jerk*u²)*u so solve that for u
+        // Newton's method converges from above as the distance is convex in u, both guesses are too long on their own
+        float u = cbrtf(distance / this->jerk);
+        if(vt > 0.0F) u = std::min(u, distance / (2.0F * vt));
+        for (int i = 0; i < 4; ++i) {
+            u -= (this->jerk * u * u * u + 2.0F * vt * u - distance) / (3.0F * this->jerk * u * u + 2.0F * vt);
+        }
+        return vt + this->jerk * u * u;
+    }
+
+    // otherwise the ramp takes dv/a + tj, solve (2*vt + dv)/2 * (dv/a + tj) = distance for dv
+    float b = vt + a * tj / 2.0F;
+    return vt + sqrtf(b * b + 2.0F * a * (distance - vt * tj)) - b;
+}
+
+// the slowest speed this block can get down to from start_velocity within the allotted distance
+float Block::min_allowable_speed(float start_velocity, float distance) const
+{
+    if(this->jerk <= 0.0F && this->shaper == nullptr) {
+        float v = start_velocity * start_velocity - 2.0F * this->acceleration * distance;
+        return (v > 0.0F) ? sqrtf(v) : 0.0F;
+    }
+
+    // the ramp is longer the bigger the speed change, so find it by bisection
+    if(ramp_distance(0.0F, start_velocity) <= distance) return 0.0F;
+    float low = 0.0F, high = start_velocity;
+    for (int i = 0; i < 16; ++i) {
+        float mid = (low + high) / 2.0F;
+        if(ramp_distance(mid, start_velocity) <= distance) high = mid;
+        else low = mid;
+    }
+    return high;
 }
 
 // Called by Planner::recalculate() when scanning the plan from last to first entry.
@@ -241,7 +458,7 @@ float Block::reverse_pass(float exit_speed)
         // If nominal length true, max junction speed is guaranteed to be reached. Only compute
         // for max allowable speed if block is decelerating and nominal length is false.
         if ((!this->nominal_length_flag) && (this->max_entry_speed > exit_speed)) {
-            float max_entry_speed = max_allowable_speed(-this->acceleration, exit_speed, this->millimeters);
+            float max_entry_speed = max_allowable_speed(exit_speed, this->millimeters);
 
             this->entry_speed = min(max_entry_speed, this->max_entry_speed);
 
@@ -296,7 +513,7 @@ float Block::max_exit_speed()
         return nominal_speed;
 
     // otherwise, we have to work out max exit speed based on entry and acceleration
-    float max = max_allowable_speed(-this->acceleration, this->entry_speed, this->millimeters);
+    float max = max_allowable_speed(this->entry_speed, this->millimeters);
 
     return min(max, nominal_speed);
 }
@@ -316,57 +533,249 @@ void Block::prepare(float acceleration_in_steps, float deceleration_in_steps)
     double acceleration_per_tick = acceleration_in_steps * fp_scale; // this is now scaled to fit a 2.30 fixed point number
     double deceleration_per_tick = deceleration_in_steps * fp_scale;
 
-    for (uint8_t m = 0; m < n_actuators; m++) {
-        uint32_t steps = this->steps[m];
-        this->tick_info[m].steps_to_move = steps;
-        if(steps == 0) continue;
+    this->next_accel_event = this->total_move_ticks + 1;
+    if(this->accelerate_until != 0) { // If the next accel event is the end of accel
+        this->next_accel_event = this->accelerate_until;
 
-        float aratio = inv * steps;
+    } else if(this->decelerate_after != 0 && this->decelerate_after != this->total_move_ticks) {
+        // If the next event is the start of decel ( don't set this if the next accel event is accel end )
+        this->next_accel_event = this->decelerate_after;
+    }
 
-        this->tick_info[m].steps_per_tick = (int64_t)round((((double)this->initial_rate * aratio) / STEP_TICKER_FREQUENCY) * STEPTICKER_FPSCALE); // steps/sec / tick frequency to get steps per tick in 2.62 fixed point
-        this->tick_info[m].counter = 0; // 2.62 fixed point
-        this->tick_info[m].step_count = 0;
-        this->tick_info[m].next_accel_event = this->total_move_ticks + 1;
+    double acceleration_change = 0;
+    if(this->accelerate_until != 0) {
+        acceleration_change = acceleration_per_tick;
 
-        double acceleration_change = 0;
-        if(this->accelerate_until != 0) { // If the next accel event is the end of accel
-            this->tick_info[m].next_accel_event = this->accelerate_until;
-            acceleration_change = acceleration_per_tick;
+    } else if(this->decelerate_after == 0 /*&& this->accelerate_until == 0*/) {
+        // we start off decelerating
+        acceleration_change = -deceleration_per_tick;
+    }
 
-        } else if(this->decelerate_after == 0 /*&& this->accelerate_until == 0*/) {
-            // we start off decelerating
-            acceleration_change = -deceleration_per_tick;
+    // S-curve, calculate_trapezoid() made the ramps long enough for the jerk, so they keep the same number of ticks and the same
+    // average acceleration but the acceleration ramps up and down at the jerk instead of being switched on and off
+    uint32_t deceleration_ticks= this->total_move_ticks - this->decelerate_after;
+    double accel_jerk_divisor, decel_jerk_divisor;
+    if(this->shaper == nullptr) {
+        this->accel_jerk_ticks= jerk_ticks(this->accelerate_until, acceleration_in_steps);
+        this->decel_jerk_ticks= jerk_ticks(deceleration_ticks, deceleration_in_steps);
+        // velocity change from n jerk ticks up, m constant ticks then n jerk ticks down is jerk*n*(n+m)
+        accel_jerk_divisor= (double)this->accel_jerk_ticks * (this->accelerate_until - this->accel_jerk_ticks);
+        decel_jerk_divisor= (double)this->decel_jerk_ticks * (deceleration_ticks - this->decel_jerk_ticks);
+
+    }else{
+        // input shaping, the velocity change is the peak times the ticks from the first impulse of the rise to the first of the fall
+        this->accel_jerk_ticks= shaper_ticks(this->accelerate_until, acceleration_in_steps);
+        this->decel_jerk_ticks= shaper_ticks(deceleration_ticks, deceleration_in_steps);
+        uint32_t decel_start= (this->accelerate_until == 0 && this->decelerate_after == 0) ? 0 : this->decelerate_after + 1;
+        accel_jerk_divisor= shaper_ramp(0, this->accelerate_until, this->accel_jerk_ticks, &this->shaper_start()[0]);
+        decel_jerk_divisor= shaper_ramp(decel_start, deceleration_ticks, this->decel_jerk_ticks, &this->shaper_start()[2]);
+    }
 
-        } else if(this->decelerate_after != this->total_move_ticks /*&& this->accelerate_until == 0*/) {
-            // If the next event is the start of decel ( don't set this if the next accel event is accel end )
-            this->tick_info[m].next_accel_event = this->decelerate_after;
-        }
+    this->jerk_phase= (this->accel_jerk_ticks > 0) ? ACCEL_JERK_UP : (this->decel_jerk_ticks > 0) ? DECEL_JERK_UP : NO_JERK;
+    this->shaper_impulse= 0;
+    this->shaper_fall_impulse= 0;
+    this->next_jerk_event= (this->shaper == nullptr) ? jerk_event_tick(this->jerk_phase) : shaper_event_tick();
+
+    // the packed values of the other motors are at most those of the one that moves the most, with a ratio of 1
+    double impulse_scale= (this->shaper != nullptr) ? 32768 : 1;
+    double accel_jerk= (this->accel_jerk_ticks > 0) ? acceleration_per_tick * this->accelerate_until / (accel_jerk_divisor * impulse_scale) : 0;
+    double decel_jerk= (this->decel_jerk_ticks > 0) ? deceleration_per_tick * deceleration_ticks / (decel_jerk_divisor * impulse_scale) : 0;
+    this->ramp_shift= pack_shift(deceleration_per_tick);
+    this->jerk_shift= pack_shift(std::max(accel_jerk, decel_jerk));
+
+    // only the motors that move have an entry
+    rampinfo_t *ramp_info= this->ramp_info();
+    jerkinfo_t *jerk_info= this->jerk_info();
+    for (uint8_t n = 0; n < this->n_active; n++) {
+        uint8_t m = this->active_motors[n];
+        uint32_t steps = (m == ARC_PATH) ? this->arc_steps : this->steps[m];
+
+        float aratio = inv * steps;
+
+        this->tick_info[n].steps_to_move = steps;
+        this->tick_info[n].steps_per_tick = (int64_t)round((((double)this->initial_rate * aratio) / STEP_TICKER_FREQUENCY) * STEPTICKER_FPSCALE); // steps/sec / tick frequency to get steps per tick in 2.62 fixed point
+        this->tick_info[n].counter = 0; // 2.62 fixed point
+        this->tick_info[n].step_count = 0;
 
         // already converted to fixed point just needs scaling by ratio
         //#define STEPTICKER_TOFP(x) ((int64_t)round((double)(x)*STEPTICKER_FPSCALE))
-        this->tick_info[m].acceleration_change= (int64_t)round(acceleration_change * aratio);
-        this->tick_info[m].deceleration_change= -(int64_t)round(deceleration_per_tick * aratio);
-        this->tick_info[m].plateau_rate= (int64_t)round(((this->maximum_rate * aratio) / STEP_TICKER_FREQUENCY) * STEPTICKER_FPSCALE);
+        this->tick_info[n].acceleration_change= (int64_t)round(acceleration_change * aratio);
+        ramp_info[n].deceleration_change= -(int32_t)llround(ldexp(deceleration_per_tick * aratio, -this->ramp_shift));
+        ramp_info[n].plateau_rate= (uint32_t)std::min(llround(((this->maximum_rate * aratio) / STEP_TICKER_FREQUENCY) * 4294967296.0), 0xFFFFFFFFLL);
+
+        if(jerk_info != nullptr) {
+            jerk_info[n].jerk= 0;
+            jerk_info[n].accel_jerk= 0;
+            jerk_info[n].decel_jerk= 0;
+            // the shaper impulses are multiples of the peak per 1/32768 of amplitude, so the acceleration goes back to exactly where it was
+            if(this->accel_jerk_ticks > 0) {
+                // acceleration starts at zero and is ramped up by the jerk, or stepped up by the shaper impulses
+                jerk_info[n].accel_jerk= (int32_t)llround(ldexp(accel_jerk * aratio, -this->jerk_shift));
+                this->tick_info[n].acceleration_change= 0;
+            }
+            if(this->decel_jerk_ticks > 0) {
+                jerk_info[n].decel_jerk= (int32_t)llround(ldexp(decel_jerk * aratio, -this->jerk_shift));
+                ramp_info[n].deceleration_change= 0;
+                if(this->accelerate_until == 0 && this->decelerate_after == 0) this->tick_info[n].acceleration_change= 0;
+            }
+        }
 
         #if 0
         THEKERNEL->streams->printf("spt: %08lX %08lX, ac: %08lX %08lX, dc: %08lX %08lX, pr: %08lX %08lX\n",
-            (uint32_t)(this->tick_info[m].steps_per_tick>>32), // 2.62 fixed point
-            (uint32_t)(this->tick_info[m].steps_per_tick&0xFFFFFFFF), // 2.62 fixed point
-            (uint32_t)(this->tick_info[m].acceleration_change>>32), // 2.62 fixed point signed
-            (uint32_t)(this->tick_info[m].acceleration_change&0xFFFFFFFF), // 2.62 fixed point signed
-            (uint32_t)(this->tick_info[m].deceleration_change>>32), // 2.62 fixed point
-            (uint32_t)(this->tick_info[m].deceleration_change&0xFFFFFFFF), // 2.62 fixed point
-            (uint32_t)(this->tick_info[m].plateau_rate>>32), // 2.62 fixed point
-            (uint32_t)(this->tick_info[m].plateau_rate&0xFFFFFFFF) // 2.62 fixed point
+            (uint32_t)(this->tick_info[n].steps_per_tick>>32), // 2.62 fixed point
+            (uint32_t)(this->tick_info[n].steps_per_tick&0xFFFFFFFF), // 2.62 fixed point
+            (uint32_t)(this->tick_info[n].acceleration_change>>32), // 2.62 fixed point signed
+            (uint32_t)(this->tick_info[n].acceleration_change&0xFFFFFFFF), // 2.62 fixed point signed
+            (uint32_t)(unpack(ramp_info[n].deceleration_change, this->ramp_shift)>>32), // 2.62 fixed point
+            (uint32_t)(unpack(ramp_info[n].deceleration_change, this->ramp_shift)&0xFFFFFFFF), // 2.62 fixed point
+            (uint32_t)(unpack_rate(ramp_info[n].plateau_rate)>>32), // 2.62 fixed point
+            (uint32_t)(unpack_rate(ramp_info[n].plateau_rate)&0xFFFFFFFF) // 2.62 fixed point
         );
         #endif
     }
 }
 
+// returns how far a 2.62 fixed point value has to be shifted down so it fits in the 31 bits of a packed value, see unpack()
+uint8_t Block::pack_shift(double value)
+{
+    int e;
+    frexp(value, &e); // value < 2^e
+    return (e > 31) ? e - 31 : 0;
+}
+
+// returns the number of ticks the jerk is applied for at each end of a ramp of the given length, 0 if it is a trapezoid ramp
+uint32_t Block::jerk_ticks(uint32_t ticks, float acceleration_in_steps) const
+{
+    if(this->jerk <= 0.0F || ticks < 2 || acceleration_in_steps <= 0.0F) return 0;
+
+    // the jerk is in mm/sec³ so convert to steps/sec³ the same way as the acceleration
+    float jerk_in_steps = (this->jerk * this->steps_event_count) / this->millimeters;
+
+    // for a ramp of T ticks with average acceleration A, the jerk J is applied for n ticks where J*n*(T-n) = A*T
+    // the peak acceleration is A*T/(T-n), rounding n down keeps it at or under the setting the ramp was planned for
+    float t = ticks;
+    float d = t * t - 4.0F * t * acceleration_in_steps * STEP_TICKER_FREQUENCY / jerk_in_steps;
+    // if the ramp is too short for the jerk it becomes a pure S-curve with no constant acceleration segment
+    uint32_t n = (d <= 0.0F) ? ticks / 2 : (uint32_t)((t - sqrtf(d)) / 2.0F);
+    if(n < 1) n = 1;
+    if(n > ticks / 2) n = ticks / 2;
+    return n;
+}
+
+// returns the number of ticks the impulses of the input shaper are spread over at each end of a ramp of the given length and
+// average acceleration, calculate_trapezoid() plans the ramps long enough for the whole shaper, only a ramp that had to be
+// squeezed into its block gets its impulses squeezed too, so the peak acceleration never goes over the setting
+uint32_t Block::shaper_ticks(uint32_t ticks, float acceleration_in_steps) const
+{
+    if(ticks < 2 || acceleration_in_steps <= 0.0F) return 0;
+
+    // the peak is the average acceleration times the ticks of the ramp over the ticks left once the shaper span is taken out
+    float acceleration_per_second = (this->acceleration * this->steps_event_count) / this->millimeters;
+    uint32_t ramp= std::max<uint32_t>(ceilf(ticks * acceleration_in_steps / acceleration_per_second), 1);
+    if(ramp >= ticks) return 0;
+    uint32_t spread= std::min(this->shaper->duration, (uint32_t)floorf((ticks - ramp) / this->shaper->span));
+    while(spread > 0 && shaper_span(spread) > ticks - ramp) --spread;
+    return spread;
+}
+
+// returns the ticks of a ramp used up by the impulses of the shaper spread over the given ticks, see InputShaper::span
+uint32_t Block::shaper_span(uint32_t spread) const
+{
+    uint32_t delay= lroundf(this->shaper->start * spread);
+    return std::max<uint32_t>(lroundf(this->shaper->span * spread), delay + spread);
+}
+
+// sets the ticks of the first impulse of the rise and the fall of a ramp that starts on the given tick and has its impulses spread
+// over the given ticks, returns the ticks between them, the velocity change of the ramp is its peak acceleration times that
+uint32_t Block::shaper_ramp(uint32_t start_tick, uint32_t ticks, uint32_t spread, uint32_t start[2]) const
+{
+    if(spread == 0) return 0;
+    uint32_t delay= lroundf(this->shaper->start * spread);
+    uint32_t span= shaper_span(spread);
+    start[0]= start_tick + delay;
+    start[1]= start_tick + delay + ticks - span;
+    return ticks - span;
+}
+
+// returns the tick the next impulse of the input shaper is due on, of the rise or of the fall of the ramp whichever is first
+uint32_t Block::shaper_event_tick() const
+{
+    if(this->jerk_phase == NO_JERK) return UINT32_MAX;
+    uint32_t rise= (this->shaper_impulse < this->shaper->n_impulses) ? shaper_impulse_tick(0, this->shaper_impulse) : UINT32_MAX;
+    uint32_t fall= (this->shaper_fall_impulse < this->shaper->n_impulses) ? shaper_impulse_tick(1, this->shaper_fall_impulse) : UINT32_MAX;
+    return std::min(rise, fall);
+}
+
+// returns the tick of the given impulse of the rise (0) or fall (1) of the acceleration in the ramp of the current phase
+uint32_t Block::shaper_impulse_tick(uint8_t fall, uint8_t impulse) const
+{
+    bool decel= this->jerk_phase >= DECEL_JERK_UP;
+    uint32_t ticks= decel ? this->decel_jerk_ticks : this->accel_jerk_ticks;
+    return this->shaper_start()[(decel ? 2 : 0) + fall] + ((this->shaper->time[impulse] * ticks + (1 << 14)) >> 15);
+}
+
+// returns the amplitude of the input shaper impulse that is due, with the sign of the change in acceleration, then moves on to the next one
+// called from the step ticker ISR
+int32_t Block::next_shaper_impulse()
+{
+    bool decel= this->jerk_phase >= DECEL_JERK_UP;
+    uint32_t fall= (this->shaper_fall_impulse < this->shaper->n_impulses) ? shaper_impulse_tick(1, this->shaper_fall_impulse) : UINT32_MAX;
+
+    // the acceleration rises then falls back to zero, the deceleration does the same the other way
+    int32_t a;
+    if(this->shaper_impulse < this->shaper->n_impulses && shaper_impulse_tick(0, this->shaper_impulse) <= fall) {
+        a= this->shaper->amplitude[this->shaper_impulse++];
+    } else {
+        a= -this->shaper->amplitude[this->shaper_fall_impulse++];
+    }
+    if(decel) a= -a;
+
+    if(this->shaper_fall_impulse == this->shaper->n_impulses) {
+        // the last impulse of the fall is the last of the ramp, there are no impulses in the other phases
+        this->shaper_impulse= 0;
+        this->shaper_fall_impulse= 0;
+        this->jerk_phase= (!decel && this->decel_jerk_ticks > 0) ? DECEL_JERK_UP : NO_JERK;
+    }
+    this->next_jerk_event= shaper_event_tick();
+    return a;
+}
+
+// returns the tick that the given jerk phase starts on
+uint32_t Block::jerk_event_tick(uint8_t phase) const
+{
+    uint32_t deceleration_ticks= this->total_move_ticks - this->decelerate_after;
+    // deceleration starts on the tick after decelerate_after unless the block starts off decelerating
+    uint32_t decel_start= (this->accelerate_until == 0 && this->decelerate_after == 0) ? 0 : this->decelerate_after + 1;
+
+    if(phase <= ACCEL_DONE && this->accel_jerk_ticks == 0) phase= DECEL_JERK_UP;
+    if(phase >= DECEL_JERK_UP && this->decel_jerk_ticks == 0) phase= NO_JERK;
+
+    switch(phase) {
+        case ACCEL_JERK_UP:   return 0;
+        case ACCEL_CONSTANT:  return this->accel_jerk_ticks;
+        case ACCEL_JERK_DOWN: return this->accelerate_until - this->accel_jerk_ticks;
+        case ACCEL_DONE:      return this->accelerate_until;
+        case DECEL_JERK_UP:   return decel_start;
+        case DECEL_CONSTANT:  return decel_start + this->decel_jerk_ticks;
+        case DECEL_JERK_DOWN: return decel_start + deceleration_ticks - this->decel_jerk_ticks;
+        case DECEL_DONE:      return decel_start + deceleration_ticks;
+    }
+    return UINT32_MAX;
+}
+
 // returns current rate (steps/sec) for the given actuator
 float Block::get_trapezoid_rate(int i) const
 {
     // convert steps per tick from fixed point to float and convert to steps/sec
     // FIXME steps_per_tick can change at any time, potential race condition if it changes while being read here
-    return STEPTICKER_FROMFP(tick_info[i].steps_per_tick) * STEP_TICKER_FREQUENCY;
+    for (uint8_t n = 0; n < n_active; n++) {
+        if(active_motors[n] == i) return STEPTICKER_FROMFP(tick_info[n].steps_per_tick) * STEP_TICKER_FREQUENCY;
+    }
+
+    // the plane axes of an arc do not have a fixed rate, so use their average rate from the rate along the arc
+    const arcinfo_t *arc_info= this->arc_info();
+    if(arc_info != nullptr && (arc_info->motor[0] == i || arc_info->motor[1] == i)) {
+        return get_trapezoid_rate(ARC_PATH) * steps[i] / arc_steps;
+    }
+    return 0;
 }
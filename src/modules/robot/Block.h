@@ -10,27 +10,51 @@
 #include <bitset>
 #include "ActuatorCoordinates.h"
 
+class MemoryPool;
+class InputShaper;
+
+// a move that follows an arc in the plane of two actuators, the other actuators move in proportion to the length along the arc
+struct ArcPath {
+    uint8_t axis[2];        // the two actuators of the plane
+    float center[2];        // the centre of the arc in actuator mm
+    float start[2];         // the start and end positions relative to the centre
+    float end[2];
+    float angle;            // radians, positive turns from axis[0] towards axis[1], at most 90° so neither axis changes direction
+    float exit_unit_vec[N_PRIMARY_AXIS]; // the direction of travel at the end of the arc, used for the next junction
+};
+
 class Block {
     public:
         Block();
 
-        static void init(uint8_t);
+        static bool init(uint8_t, uint16_t);
 
         void calculate_trapezoid( float entry_speed, float exit_speed );
 
         float reverse_pass(float exit_speed);
         float forward_pass(float next_entry_speed);
         float max_exit_speed();
+        float max_allowable_speed(float target_velocity, float distance) const;
+        float min_allowable_speed(float start_velocity, float distance) const;
         void debug() const;
         void ready() { is_ready= true; }
         void clear();
+        bool allocate_tick_info(const ArcPath *arc, uint16_t raster_pixels, bool speed_override);
+        void setup_arc(const ArcPath& arc, const int32_t start_steps[2], const float steps_per_mm[2]);
         float get_trapezoid_rate(int i) const;
 
     private:
-        float max_allowable_speed( float acceleration, float target_velocity, float distance);
+        float ramp_time(float speed_change) const;
+        float ramp_distance(float start_speed, float end_speed) const;
         void prepare(float acceleration_in_steps, float deceleration_in_steps);
+        static uint8_t pack_shift(double value);
+        uint32_t jerk_ticks(uint32_t ticks, float acceleration_in_steps) const;
+        uint32_t shaper_ticks(uint32_t ticks, float acceleration_in_steps) const;
+        uint32_t shaper_span(uint32_t spread) const;
+        uint32_t shaper_ramp(uint32_t start_tick, uint32_t ticks, uint32_t spread, uint32_t start[2]) const;
 
         static double fp_scale; // optimize to store this as it does not change
+        static MemoryPool *tick_pool; // the tick info for the queued blocks is allocated from here
 
     public:
         std::array<uint32_t, k_max_actuators> steps; // Number of steps for each axis for this block
@@ -41,31 +65,113 @@ class Block {
         float entry_speed;
         float exit_speed;
         float acceleration;       // the acceleration for this block
+        float jerk;               // the jerk for the S-curve, 0 for a trapezoid
+        const InputShaper *shaper; // the input shaper for the ramps, nullptr if they are not shaped, it is used instead of the S-curve
         float initial_rate;       // Initial rate in steps per second
         float maximum_rate;
 
         float max_entry_speed;
+        float max_junction_speed; // the junction speed before it is limited by the nominal speeds, 0 if it does not depend on them
 
         // this is tick info needed for this block. applies to all motors
         uint32_t accelerate_until;
         uint32_t decelerate_after;
         uint32_t total_move_ticks;
+        uint32_t queued_ticks;    // total_move_ticks when it was queued, for the conveyor's running total of the queued time
         std::bitset<k_max_actuators> direction_bits;     // Direction for each axis in bit form, relative to the direction port's mask
 
-        // this is the data needed to determine when each motor needs to be issued a step
+        // this is the data needed to determine when each motor needs to be issued a step, it is used on every tick
+        // there is only an entry for each motor that moves in this block, active_motors gives the actuator for each entry
         using tickinfo_t= struct {
             int64_t steps_per_tick; // 2.62 fixed point
             int64_t counter; // 2.62 fixed point
             int64_t acceleration_change; // 2.62 fixed point signed
-            int64_t deceleration_change; // 2.62 fixed point
-            int64_t plateau_rate; // 2.62 fixed point
             uint32_t steps_to_move;
             uint32_t step_count;
-            uint32_t next_accel_event;
         };
 
-        // need info for each active motor
+        // this is only needed at the acceleration events so is kept out of the way, and packed into 32 bits as it is only read there
+        using rampinfo_t= struct {
+            int32_t deceleration_change; // 2.62 fixed point signed shifted down by ramp_shift, see unpack()
+            uint32_t plateau_rate; // 0.32 fixed point, the 2.62 rate shifted down by 30 as it is never more than a step per tick
+        };
+
+        // this is only allocated for an S-curve or input shaping, when shaped accel_jerk and decel_jerk are the peak acceleration of each ramp
+        // divided by 32768 so the impulses of the shaper (1.15 fixed point amplitudes that add up to 1) add up to exactly the peak
+        using jerkinfo_t= struct {
+            int64_t jerk; // 2.62 fixed point signed, the current jerk
+            int32_t accel_jerk; // 2.62 fixed point shifted down by jerk_shift
+            int32_t decel_jerk; // 2.62 fixed point shifted down by jerk_shift
+        };
+
+        // the packed values keep the 31 most significant bits of the largest one in the block, which is that of the primary axis
+        static int64_t unpack(int32_t value, uint8_t shift) { return (int64_t)value * ((int64_t)1 << shift); }
+        static int64_t unpack_rate(uint32_t rate) { return (int64_t)rate << 30; }
+
+        // so M220 can change the speed of the block after it was planned, this is only allocated if the speed override applies to it
+        using speedinfo_t= struct {
+            float programmed_speed; // mm/s at a speed override of 100%
+            float max_speed;        // mm/s, the fastest the axis and actuator speed limits allow for this block
+        };
+
+        // this is only allocated for an arc, the plane axes do not have tick info, instead there is a tick info entry for the
+        // steps along the arc (active_motors is ARC_PATH) and on each of those the plane axes are stepped if they are due
+        using arcinfo_t= struct {
+            int64_t pos[2]; // 32.32 fixed point position in steps of each plane axis relative to the centre
+            int64_t end[2]; // 32.32 fixed point where the arc finishes
+            int64_t next[2]; // 32.32 fixed point position where the next step is issued
+            uint32_t steps_to_move[2];
+            uint32_t step_count[2];
+            int32_t cos_m, sin_m[2]; // the rotation per path step is 1 - cos_m and +/- sin_m, each scaled by the shift
+            uint8_t cos_shift, sin_shift[2];
+            uint8_t motor[2];
+            bool forward[2]; // set if the plane axis moves to larger step positions
+        };
+
+        // all of these are in one allocation from the tick pool, only for the motors that move, in this order
+        // tick info, ramp info, jerk info and the shaper starts, speed info, arc info then the raster pixels
+        // the parts that a block does not need are left out, so only the tick info has a pointer and the others are found from it
         tickinfo_t *tick_info;
+        rampinfo_t *ramp_info() const { return (rampinfo_t *)(tick_info + n_active); }
+        jerkinfo_t *jerk_info() const { return (jerk > 0.0F || shaper != nullptr) ? (jerkinfo_t *)(ramp_info() + n_active) : nullptr; }
+        speedinfo_t *speed_info() const { return has_speed_info ? (speedinfo_t *)((uint8_t *)tick_info + tail_offset) : nullptr; }
+        arcinfo_t *arc_info() const { return (arc_steps > 0) ? (arcinfo_t *)((uint8_t *)tick_info + tail_offset + (has_speed_info ? sizeof(speedinfo_t) : 0)) : nullptr; }
+        uint8_t *raster() const { return (raster_pixels > 0) ? (uint8_t *)tick_info + raster_offset : nullptr; }
+        uint16_t tail_offset; // where the speed info would start
+        uint16_t raster_offset;
+        std::array<uint8_t, k_max_actuators> active_motors;
+        uint8_t n_active;
+        static const uint8_t ARC_PATH= 0xFF; // the active_motors entry for the steps along an arc
+        uint32_t arc_steps; // number of steps along the arc, 0 if not an arc
+
+        // a raster line has a power for each pixel along the move, each scales s_value from 0 to 255, allocated with the tick info
+        // the sdcard player takes lines of up to 128 characters, this leaves room for G1 X Y F S D before the two hex digits per pixel
+        static const uint16_t max_raster_pixels= 48;
+        uint16_t raster_pixels; // 0 if not a raster line
+        uint32_t next_accel_event; // tick of the next acceleration event, the same for all motors
+
+        // S-curve, the acceleration and deceleration ramps each have a jerk up, constant and jerk down segment
+        // the jerk events happen at the start of the tick, the acceleration events at the end
+        enum JERK_PHASE { ACCEL_JERK_UP, ACCEL_CONSTANT, ACCEL_JERK_DOWN, ACCEL_DONE, DECEL_JERK_UP, DECEL_CONSTANT, DECEL_JERK_DOWN, DECEL_DONE, NO_JERK };
+        uint32_t jerk_event_tick(uint8_t phase) const;
+        uint32_t accel_jerk_ticks;
+        uint32_t decel_jerk_ticks;
+        uint32_t next_jerk_event;
+        uint8_t jerk_phase;
+
+        // input shaping convolves the acceleration of each ramp with the shaper, the step up and the step down of the acceleration
+        // are each split into the impulses of the shaper spread over the jerk ticks of the ramp. In a ramp shorter than the shaper
+        // the impulses of the fall start before those of the rise are over, so all of them are in the jerk up phase of the ramp
+        uint32_t shaper_event_tick() const;
+        uint32_t shaper_impulse_tick(uint8_t fall, uint8_t impulse) const;
+        int32_t next_shaper_impulse();
+        // the tick of the first impulse of the rise and fall of the acceleration, then of the deceleration, after the jerk info
+        uint32_t *shaper_start() const { return (uint32_t *)(jerk_info() + n_active); }
+        uint8_t shaper_impulse;      // the next impulse of the rise
+        uint8_t shaper_fall_impulse; // the next impulse of the fall
+
+        uint8_t ramp_shift; // the shift of the packed deceleration_change of the ramp info
+        uint8_t jerk_shift; // the shift of the packed accel_jerk and decel_jerk of the jerk info
 
         static uint8_t n_actuators;
 
@@ -77,6 +183,7 @@ class Block {
             bool is_g123:1;                      // set if this is a G1, G2 or G3
             volatile bool is_ticking:1;          // set when this block is being actively ticked by the stepticker
             volatile bool locked:1;              // set to true when the critical data is being updated, stepticker will have to skip if this is set
+            bool has_speed_info:1;               // set if the speed override applies to this block
             uint16_t s_value:12;                 // for laser 1.11 Fixed point
         };
 };
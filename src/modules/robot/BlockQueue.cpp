@@ -141,6 +141,14 @@ bool BlockQueue::is_full() const
     return r;
 }
 
+// blocks that can be queued before it is full, finished blocks count once they have been cleaned up
+unsigned int BlockQueue::free_count() const
+{
+    if (length == 0)
+        return 0;
+    return (tail_i + length - head_i - 1) % length;
+}
+
 bool BlockQueue::is_empty() const
 {
     //__disable_irq();
@@ -182,6 +190,7 @@ bool BlockQueue::resize(unsigned int length)
 
         // Note: we don't use realloc so we can fall back to the existing ring if allocation fails
         void *v= AHB0.alloc(sizeof(Block) * length);
+        if (v == nullptr) return false;
         Block* newring = new(v) Block[length];
 
         if (newring != nullptr)
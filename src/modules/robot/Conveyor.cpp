@@ -29,6 +29,8 @@
 
 #define planner_queue_size_checksum CHECKSUM("planner_queue_size")
 #define queue_delay_time_ms_checksum CHECKSUM("queue_delay_time_ms")
+#define queue_fill_time_ms_checksum CHECKSUM("queue_fill_time_ms")
+#define queue_starvation_time_ms_checksum CHECKSUM("queue_starvation_time_ms")
 
 /*
  * The conveyor holds the queue of blocks, takes care of creating them, and starting the executing chain of blocks
@@ -63,6 +65,7 @@ Conveyor::Conveyor()
     running = false;
     allow_fetch = false;
     flush= false;
+    starving= false;
 }
 
 void Conveyor::on_module_loaded()
@@ -74,13 +77,25 @@ void Conveyor::on_module_loaded()
     //THEKERNEL->step_ticker->finished_fnc = std::bind( &Conveyor::all_moves_finished, this);
     queue_size = THEKERNEL->config->value(planner_queue_size_checksum)->by_default(32)->as_number();
     queue_delay_time_ms = THEKERNEL->config->value(queue_delay_time_ms_checksum)->by_default(100)->as_number();
+    queue_fill_time_ms = THEKERNEL->config->value(queue_fill_time_ms_checksum)->by_default(0)->as_number(); // disabled by default
+    queue_starvation_time_ms = THEKERNEL->config->value(queue_starvation_time_ms_checksum)->by_default(0)->as_number(); // disabled by default
 }
 
 // we allocate the queue here after config is completed so we do not run out of memory during config
 void Conveyor::start(uint8_t n)
 {
-    Block::init(n); // set the number of motors which determines how big the tick info vector is
-    queue.resize(queue_size);
+    // if the queue and the tick info for it do not fit in memory the queue is made shorter, that only shortens the lookahead
+    size_t size= queue_size;
+    while(!queue.resize(size) || !Block::init(n, size)) { // set the number of motors and the queue size which determine how big the tick info pool is
+        queue.resize(0);
+        if(size <= 4) __debugbreak(); // not even a short queue fits
+        size -= size / 4;
+    }
+
+    if(size != queue_size) {
+        THEKERNEL->streams->printf("Warning: not enough memory for planner_queue_size %d, it was reduced to %d\n", (int)queue_size, (int)size);
+        queue_size= size;
+    }
     running = true;
 }
 
@@ -130,6 +145,9 @@ bool Conveyor::is_idle() const
 // Wait for the queue to be empty and for all the jobs to finish in step ticker
 void Conveyor::wait_for_idle(bool wait_for_motors)
 {
+    // a line still being merged by Robot has to be queued before we can wait for it
+    THEROBOT->flush_coalesced_line();
+
     // wait for the job queue to empty, this means cycling everything on the block queue into the job queue
     // forcing them to be jobs
     running = false; // stops on_idle calling check_queue
@@ -167,12 +185,26 @@ void Conveyor::queue_head_block()
         return; // if we got a halt then we are done here
     }
 
+    // the queued time is counted with the ticks the block has now, before the blocks after it are planned
+    Block *b= queue.head_ref();
+    b->queued_ticks= b->total_move_ticks;
     queue.produce_head();
+    queued_ticks_in += b->queued_ticks;
 
     // not sure if this is the correct place but we need to turn on the motors if they were not already on
     THEKERNEL->call_event(ON_ENABLE, (void*)1); // turn all enable pins on
     // we may have enough to start the queue now
     check_queue();
+    // if the step ticker is running it can get this block ready
+    if(allow_fetch) THEKERNEL->step_ticker->prepare_next_block();
+}
+
+// returns the execution time in seconds of the blocks that are queued, including the one being ticked until it finishes
+// each block is counted with the time it had when it was queued, when it was planned to stop at the end, so this is an estimate
+// on the long side, replanning it when more blocks are queued can only make it shorter
+float Conveyor::get_queued_time() const
+{
+    return (float)(queued_ticks_in - queued_ticks_out) / THEKERNEL->step_ticker->get_frequency();
 }
 
 void Conveyor::check_queue(bool force)
@@ -185,9 +217,25 @@ void Conveyor::check_queue(bool force)
         return;
     }
 
-    // if we have been waiting for more than the required waiting time and the queue is not empty, or the queue is full, then allow stepticker to get the tail
+    if(allow_fetch && queue_starvation_time_ms > 0) {
+        // the step ticker is running, see if the planner is keeping up with it
+        // NOTE this also counts the end of a job as the queue drains
+        bool low = get_queued_time() * 1000.0F < queue_starvation_time_ms;
+        if(low && !starving) ++starvation_count;
+        starving = low;
+    }
+
+    // if we have been waiting for more than the required waiting time and the queue is not empty, or the queue is full,
+    // or there is enough motion queued to run for queue_fill_time_ms, then allow stepticker to get the tail
     // we do this to allow an idle system to pre load the queue a bit so the first few blocks run smoothly.
-    if(force || queue.is_full() || (us_ticker_read() - last_time_check) >= (queue_delay_time_ms * 1000)) {
+    // NOTE the first block is not counted as its exit speed is fixed once it starts, so the blocks after it must be there to plan into
+    bool filled = false;
+    if(!allow_fetch && queue_fill_time_ms > 0) {
+        float first = (float)queue.item_ref(queue.isr_tail_i)->queued_ticks / THEKERNEL->step_ticker->get_frequency();
+        filled = (get_queued_time() - first) * 1000.0F >= queue_fill_time_ms;
+    }
+
+    if(force || filled || queue.is_full() || (us_ticker_read() - last_time_check) >= (queue_delay_time_ms * 1000)) {
         last_time_check = us_ticker_read(); // reset timeout
         if(!flush) allow_fetch = true;
         return;
@@ -200,6 +248,7 @@ bool Conveyor::get_next_block(Block **block)
     // mark entire queue for GC if flush flag is asserted
     if (flush){
         while (queue.isr_tail_i != queue.head_i) {
+            queued_ticks_out += queue.item_ref(queue.isr_tail_i)->queued_ticks;
             queue.isr_tail_i = queue.next(queue.isr_tail_i);
         }
         flush = false;
@@ -228,10 +277,41 @@ bool Conveyor::get_next_block(Block **block)
     return false;
 }
 
+// called from PendSV while the step ticker is running the block at isr_tail_i, gets the one after it
+// once it is marked as ticking the planner leaves it alone, the same as the block being stepped
+bool Conveyor::get_following_block(Block **block)
+{
+    if(flush || !allow_fetch || THEKERNEL->is_halted() || queue.isr_tail_i == queue.head_i) return false;
+
+    unsigned int i= queue.next(queue.isr_tail_i);
+    if(i == queue.head_i) return false; // we do not have anything to give
+
+    Block *b= queue.item_ref(i);
+    // we cannot use this now if it is being updated
+    if(b->locked) return false;
+    if(!b->is_ready) __debugbreak(); // should never happen
+
+    b->is_ticking= true;
+    b->recalculate_flag= false;
+    *block= b;
+    return true;
+}
+
+// called from step ticker ISR when it starts the block it got from get_following_block() after calling block_finished()
+// returns false if the queue has been flushed since, get_next_block() then does the flush
+bool Conveyor::take_following_block(const Block *block)
+{
+    if(flush || THEKERNEL->is_halted()) return false;
+
+    this->current_feedrate= block->nominal_speed;
+    return true;
+}
+
 // called from step ticker ISR when block is finished, do not do anything slow here
 void Conveyor::block_finished()
 {
     // we increment the isr_tail_i so we can get the next block
+    queued_ticks_out += queue.item_ref(queue.isr_tail_i)->queued_ticks;
     queue.isr_tail_i= queue.next(queue.isr_tail_i);
 }
 
@@ -241,13 +321,40 @@ void Conveyor::block_finished()
     queue_head_block() so after this flush, once main_loop runs again one more
     gcode gets stuck in the queue, this is bad. Current work around is to call
     this when the queue in not full and streaming has stopped
+
+    Unless we are halted the moves are first brought to a stop with a feed hold so
+    the motors decelerate, this waits for that so must be called from the main loop
 */
 void Conveyor::flush_queue()
 {
+    // a line still being merged by Robot goes with the rest of the queue, wait_for_idle() would plan it otherwise
+    THEROBOT->drop_coalesced_line();
+
+    bool stopping= !THEKERNEL->is_halted() && !is_idle();
+    if(stopping) {
+        // just poll, ON_IDLE would run the other modules (and this one) from inside whatever called us.
+        // stopping takes as long as the deceleration of the current block, twice that as the ramp of the block uses up some of
+        // the acceleration, if it has not stopped by then the block it is in is left to finish
+        uint32_t timeout= 2 * THEKERNEL->step_ticker->get_stop_time_us() + 1000;
+        THEKERNEL->step_ticker->set_hold(true);
+        uint32_t start= us_ticker_read();
+        while(!THEKERNEL->step_ticker->is_held() && !THEKERNEL->is_halted()) {
+            if(us_ticker_read() - start >= timeout) {
+                THEKERNEL->streams->printf("Warning: the moves did not stop in time, the current one will finish\n");
+                break;
+            }
+            wait_us(100);
+        }
+    }
+
     allow_fetch = false;
     flush= true;
 
-    // TODO force deceleration of last block
+    if(stopping) {
+        // what is left of the block it stopped in goes with the rest of the queue
+        THEKERNEL->step_ticker->drop_held_block();
+        THEKERNEL->step_ticker->set_hold(false);
+    }
 }
 
 // Debug function
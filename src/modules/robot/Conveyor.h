@@ -25,16 +25,22 @@ public:
     void wait_for_idle(bool wait_for_motors=true);
     bool is_queue_empty() { return queue.is_empty(); };
     bool is_queue_full() { return queue.is_full(); };
+    unsigned int get_free_blocks() const { return queue.free_count(); }
     bool is_idle() const;
 
     // returns next available block writes it to block and returns true
     bool get_next_block(Block **block);
     void block_finished();
+    // the block after the one being stepped, so the step ticker can get it ready ahead of time
+    bool get_following_block(Block **block);
+    bool take_following_block(const Block *block);
 
     void dump_queue(void);
     void flush_queue(void);
     float get_current_feedrate() const { return current_feedrate; }
     void force_queue() { check_queue(true); }
+    float get_queued_time() const;
+    uint32_t get_starvation_count() const { return starvation_count; }
 
     friend class Planner; // for queue
 
@@ -46,6 +52,13 @@ private:
     Queue_t queue;  // Queue of Blocks
 
     uint32_t queue_delay_time_ms;
+    uint32_t queue_fill_time_ms;       // start fetching once this much motion is queued
+    uint32_t queue_starvation_time_ms; // count a starvation when less than this much motion is queued
+    uint32_t starvation_count{0};
+    // the running total of the queued time, the ticks of each block are added when it is queued and taken off when it is finished
+    // the main loop only adds and the step ticker ISR only takes off, so neither has to lock the other out
+    volatile uint32_t queued_ticks_in{0};
+    volatile uint32_t queued_ticks_out{0};
     size_t queue_size;
     float current_feedrate{0}; // actual nominal feedrate that current block is running at in mm/sec
 
@@ -53,6 +66,7 @@ private:
         volatile bool running:1;
         volatile bool allow_fetch:1;
         volatile bool flush:1;
+        volatile bool starving:1;
     };
 
 };
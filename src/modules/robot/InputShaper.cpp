@@ -0,0 +1,139 @@
+/*
+      This file is part of Smoothie (http://smoothieware.org/). The motion control part is heavily based on Grbl (https://github.com/simen/grbl).
+      Smoothie is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+      Smoothie is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+      You should have received a copy of the GNU General Public License along with Smoothie. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "InputShaper.h"
+#include "libs/Kernel.h"
+#include "StepTicker.h"
+
+#include <math.h>
+#include <string.h>
+#include <algorithm>
+
+#define PI 3.14159265358979F
+
+uint8_t InputShaper::type_from_string(const char *s)
+{
+    if(strcmp(s, "zv") == 0) return ZV;
+    if(strcmp(s, "mzv") == 0) return MZV;
+    if(strcmp(s, "ei") == 0) return EI;
+    return NONE;
+}
+
+const char *InputShaper::type_to_string(uint8_t type)
+{
+    switch(type) {
+        case ZV:  return "zv";
+        case MZV: return "mzv";
+        case EI:  return "ei";
+    }
+    return "none";
+}
+
+// the impulses of the shaper for one axis, times in seconds, returns how many there are
+static uint8_t axis_impulses(uint8_t type, float frequency, float damping, float t[3], float a[3])
+{
+    if(type == InputShaper::NONE || frequency <= 0.0F) return 0;
+
+    if(damping < 0.0F) damping = 0.0F;
+    if(damping > 0.99F) damping = 0.99F;
+    float s = sqrtf(1.0F - damping * damping);
+    float td = 1.0F / (frequency * s); // period of the damped ringing
+    uint8_t n;
+
+    switch(type) {
+        case InputShaper::ZV: {
+            float k = expf(-damping * PI / s);
+            t[0] = 0;           a[0] = 1.0F;
+            t[1] = 0.5F * td;   a[1] = k;
+            n = 2;
+            break;
+        }
+        case InputShaper::MZV: {
+            float k = expf(-0.75F * damping * PI / s);
+            float a1 = 1.0F - 1.0F / sqrtf(2.0F);
+            t[0] = 0;           a[0] = a1;
+            t[1] = 0.375F * td; a[1] = (sqrtf(2.0F) - 1.0F) * k;
+            t[2] = 0.75F * td;  a[2] = a1 * k * k;
+            n = 3;
+            break;
+        }
+        default: { // EI with a 5% vibration tolerance
+            const float v = 0.05F;
+            float k = expf(-damping * PI / s);
+            t[0] = 0;           a[0] = 0.25F * (1.0F + v);
+            t[1] = 0.5F * td;   a[1] = 0.5F * (1.0F - v) * k;
+            t[2] = td;          a[2] = 0.25F * (1.0F + v) * k * k;
+            n = 3;
+        }
+    }
+
+    float sum = 0;
+    for (int i = 0; i < n; ++i) sum += a[i];
+    for (int i = 0; i < n; ++i) a[i] /= sum;
+    return n;
+}
+
+void InputShaper::set(uint8_t type, uint8_t n_axis, const float frequency[], const float damping[])
+{
+    // start with a single impulse and convolve it with the shaper of each axis
+    float t[max_impulses]{0}, a[max_impulses]{1.0F};
+    uint8_t n = 1;
+    for (int i = 0; i < n_axis; ++i) {
+        float at[3], aa[3];
+        uint8_t an = axis_impulses(type, frequency[i], damping[i], at, aa);
+        if(an == 0) continue;
+
+        float ct[max_impulses], ca[max_impulses];
+        uint8_t cn = 0;
+        for (int j = 0; j < n; ++j) {
+            for (int k = 0; k < an && cn < max_impulses; ++k) {
+                ct[cn] = t[j] + at[k];
+                ca[cn++] = a[j] * aa[k];
+            }
+        }
+
+        // keep them in time order, impulses that happen together are merged
+        n = 0;
+        for (int j = 0; j < cn; ++j) {
+            int k = n;
+            while(k > 0 && t[k - 1] > ct[j]) --k;
+            if(k > 0 && fabsf(t[k - 1] - ct[j]) < 1e-6F) {
+                a[k - 1] += ca[j];
+                continue;
+            }
+            memmove(&t[k + 1], &t[k], (n - k) * sizeof(float));
+            memmove(&a[k + 1], &a[k], (n - k) * sizeof(float));
+            t[k] = ct[j];
+            a[k] = ca[j];
+            ++n;
+        }
+    }
+
+    this->duration = lroundf(t[n - 1] * THEKERNEL->step_ticker->get_frequency());
+    if(n < 2 || this->duration == 0) {
+        this->duration = 0;
+        this->n_impulses = 0;
+        return;
+    }
+
+    // the amplitudes must add up to exactly 1 so the acceleration goes back to where it was, any rounding goes on the first one
+    int32_t sum = 0;
+    float centroid = 0;
+    for (int i = 0; i < n; ++i) {
+        this->time[i] = lroundf(t[i] / t[n - 1] * 32768);
+        this->amplitude[i] = lroundf(a[i] * 32768);
+        sum += this->amplitude[i];
+        centroid += a[i] * t[i] / t[n - 1];
+    }
+    this->amplitude[0] += 32768 - sum;
+    this->n_impulses = n;
+
+    // a ramp covers the same distance as a trapezoid if the centroid of the shaped acceleration is in the middle of the ramp
+    float m = std::max(centroid, 1.0F - centroid);
+    this->span = 2.0F * m;
+    this->start = m - centroid;
+}
@@ -0,0 +1,40 @@
+/*
+      This file is part of Smoothie (http://smoothieware.org/). The motion control part is heavily based on Grbl (https://github.com/simen/grbl).
+      Smoothie is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later version.
+      Smoothie is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for more details.
+      You should have received a copy of the GNU General Public License along with Smoothie. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <stdint.h>
+
+// The impulses of an input shaper. Each step in the acceleration of a block is split into these impulses, so the ringing each impulse
+// excites at the shaper frequency is cancelled by the next ones. This convolves the acceleration ramps of each block with the shaper,
+// the ramps are planned longer by the time the shaper takes so the peak stays at the acceleration setting, but it is done within
+// each block so it is not the same as convolving the whole move: the change of direction at a junction between blocks is not shaped,
+// and a block too short for the whole shaper gets its impulses spread over fewer ticks, which shapes a higher frequency.
+// A shaper for several axes is the convolution of the shaper of each axis, so it cancels the ringing at all their frequencies.
+class InputShaper {
+    public:
+        InputShaper() : duration(0), span(1), start(0), n_impulses(0) {}
+
+        enum TYPE { NONE, ZV, MZV, EI };
+        static uint8_t type_from_string(const char *s);
+        static const char *type_to_string(uint8_t type);
+
+        // frequency is in Hz, an axis with a frequency of 0 is not shaped
+        void set(uint8_t type, uint8_t n_axis, const float frequency[], const float damping[]);
+
+        static const uint8_t max_impulses= 9; // two axes of three impulses each
+
+        uint32_t duration;                   // step ticker ticks from the first impulse to the last, 0 if there is no shaping
+        // a damped shaper is not symmetric, so to cover the same distance as a trapezoid ramp the impulses of the rise start a little
+        // after the start of the ramp or those of the fall end a little before its end, span is the ramp time used up by the shaper
+        // and start the delay before the first impulse, both as a fraction of the duration
+        float span;
+        float start;
+        uint8_t n_impulses;
+        uint16_t time[max_impulses];         // 1.15 fixed point fraction of the duration, the first is 0 and the last is 1
+        uint16_t amplitude[max_impulses];    // 1.15 fixed point, they add up to exactly 1
+};
@@ -21,13 +21,24 @@ using namespace std;
 #include "checksumm.h"
 #include "Robot.h"
 #include "ConfigValue.h"
+#include "StepTicker.h"
 
 #include <math.h>
+#include <float.h>
 #include <algorithm>
 
 #define junction_deviation_checksum    CHECKSUM("junction_deviation")
 #define z_junction_deviation_checksum  CHECKSUM("z_junction_deviation")
 #define minimum_planner_speed_checksum CHECKSUM("minimum_planner_speed")
+#define s_curve_jerk_checksum          CHECKSUM("s_curve_jerk")
+#define per_axis_junction_checksum     CHECKSUM("junction_acceleration_per_axis")
+#define input_shaper_type_checksum     CHECKSUM("input_shaper_type")
+#define input_shaper_frequency_checksum CHECKSUM("input_shaper_frequency")
+#define input_shaper_damping_checksum  CHECKSUM("input_shaper_damping")
+#define x_input_shaper_frequency_checksum CHECKSUM("x_input_shaper_frequency")
+#define y_input_shaper_frequency_checksum CHECKSUM("y_input_shaper_frequency")
+#define x_input_shaper_damping_checksum CHECKSUM("x_input_shaper_damping")
+#define y_input_shaper_damping_checksum CHECKSUM("y_input_shaper_damping")
 
 // The Planner does the acceleration math for the queue of Blocks ( movements ).
 // It makes sure the speed stays within the configured constraints ( acceleration, junction_deviation, etc )
@@ -45,15 +56,82 @@ void Planner::config_load()
     this->junction_deviation = THEKERNEL->config->value(junction_deviation_checksum)->by_default(0.05F)->as_number();
     this->z_junction_deviation = THEKERNEL->config->value(z_junction_deviation_checksum)->by_default(NAN)->as_number(); // disabled by default
     this->minimum_planner_speed = THEKERNEL->config->value(minimum_planner_speed_checksum)->by_default(0.0f)->as_number();
+    this->s_curve_jerk = THEKERNEL->config->value(s_curve_jerk_checksum)->by_default(0.0f)->as_number(); // disabled by default
+    this->per_axis_junction = THEKERNEL->config->value(per_axis_junction_checksum)->by_default(false)->as_bool(); // disabled by default, only used on cartesians
+
+    // input shaping of X and Y, each axis can have its own frequency and damping
+    this->input_shaper_type = InputShaper::type_from_string(THEKERNEL->config->value(input_shaper_type_checksum)->by_default("none")->as_string().c_str()); // disabled by default
+    float frequency = THEKERNEL->config->value(input_shaper_frequency_checksum)->by_default(0.0f)->as_number();
+    float damping = THEKERNEL->config->value(input_shaper_damping_checksum)->by_default(0.1f)->as_number();
+    this->input_shaper_frequency[X_AXIS] = THEKERNEL->config->value(x_input_shaper_frequency_checksum)->by_default(frequency)->as_number();
+    this->input_shaper_frequency[Y_AXIS] = THEKERNEL->config->value(y_input_shaper_frequency_checksum)->by_default(frequency)->as_number();
+    this->input_shaper_damping[X_AXIS] = THEKERNEL->config->value(x_input_shaper_damping_checksum)->by_default(damping)->as_number();
+    this->input_shaper_damping[Y_AXIS] = THEKERNEL->config->value(y_input_shaper_damping_checksum)->by_default(damping)->as_number();
+    update_input_shapers();
 }
 
+// The ramps of a block are shaped for the axes that move in it, so a move along one axis is not slowed down by the shaper of the other.
+// must not be called while there are shaped blocks in the queue
+void Planner::update_input_shapers()
+{
+    for (int i = 1; i < 4; ++i) {
+        float frequency[2], damping[2];
+        for (int a = X_AXIS; a <= Y_AXIS; ++a) {
+            frequency[a] = (i & (1 << a)) ? this->input_shaper_frequency[a] : 0.0F;
+            damping[a] = this->input_shaper_damping[a];
+        }
+        this->input_shapers[i].set(this->input_shaper_type, 2, frequency, damping);
+    }
+}
+
+
+// The velocity change at a junction is in the direction of unit_vec - previous_unit_vec, find the largest acceleration
+// in that direction that does not exceed the acceleration of any axis. An axis that does not have its own acceleration
+// set uses the default acceleration. The block acceleration is used if that is not limited by any axis.
+float Planner::junction_acceleration(const float unit_vec[], float acceleration) const
+{
+    float dv[N_PRIMARY_AXIS];
+    float sos = 0;
+    for (int i = 0; i < N_PRIMARY_AXIS; ++i) {
+        dv[i] = unit_vec[i] - this->previous_unit_vec[i];
+        sos += dv[i] * dv[i];
+    }
+    if(sos < 1e-12F) return acceleration;
+
+    float inv = 1.0F / sqrtf(sos);
+    float jacc = NAN;
+    for (int i = 0; i < N_PRIMARY_AXIS; ++i) {
+        float d = fabsf(dv[i]) * inv;
+        if(d < 0.00001F) continue; // this axis does not change speed
+
+        float ma = THEROBOT->actuators[i]->get_acceleration();
+        if(isnan(ma)) ma = THEROBOT->get_default_acceleration();
+        float a = ma / d;
+        if(isnan(jacc) || a < jacc) jacc = a;
+    }
+
+    return isnan(jacc) ? acceleration : jacc;
+}
 
 // Append a block to the queue, compute it's speed factors
-bool Planner::append_block( ActuatorCoordinates &actuator_pos, uint8_t n_motors, float rate_mm_s, float distance, float *unit_vec, float acceleration, float s_value, bool g123)
+// if arc is set the block follows that arc, unit_vec is then the direction at the start of the arc
+// max_rate_mm_s is the fastest the speed limits allow for this move and programmed_rate_mm_s its rate at a speed override of 100%,
+// or 0 if the speed override does not apply to it
+bool Planner::append_block( ActuatorCoordinates &actuator_pos, uint8_t n_motors, float rate_mm_s, float max_rate_mm_s, float programmed_rate_mm_s, float distance, float *unit_vec, float acceleration, float s_value, bool g123, const ArcPath *arc)
 {
     // Create ( recycle ) a new block
     Block* block = THECONVEYOR->queue.head_ref();
 
+    // where the plane axes of an arc start from
+    int32_t arc_start_steps[2];
+    float arc_steps_per_mm[2];
+    if(arc != nullptr) {
+        for (int i = 0; i < 2; ++i) {
+            arc_start_steps[i] = THEROBOT->actuators[arc->axis[i]]->get_last_milestone_steps();
+            arc_steps_per_mm[i] = THEROBOT->actuators[arc->axis[i]]->get_steps_per_mm();
+        }
+    }
+
     // Direction bits
     bool has_steps = false;
     for (size_t i = 0; i < n_motors; i++) {
@@ -107,10 +185,35 @@ bool Planner::append_block( ActuatorCoordinates &actuator_pos, uint8_t n_motors,
     }
 
     block->acceleration = acceleration; // save in block
+    block->jerk = this->s_curve_jerk;
+
+    // shape the ramps for the X and Y axes that move, along an arc both plane axes move even if it starts along one of them
+    if(block->primary_axis && unit_vec != nullptr) {
+        uint8_t shaped = 0;
+        for (int i = X_AXIS; i <= Y_AXIS; ++i) {
+            if(fabsf(unit_vec[i]) > 0.00001F || (arc != nullptr && (arc->axis[0] == i || arc->axis[1] == i))) shaped |= 1 << i;
+        }
+        if(this->input_shapers[shaped].n_impulses > 0) block->shaper = &this->input_shapers[shaped];
+    }
+
+    // get the tick info for the motors that move, if the pool is used up wait for the blocks ahead of this one to finish
+    bool speed_override= distance > 0.0F && programmed_rate_mm_s > 0.0F;
+    while(!block->allocate_tick_info(arc, THEROBOT->raster_pixels, speed_override)) {
+        if(THEKERNEL->is_halted()) {
+            // same as queue_head_block(), release the head block and we are done here
+            block->clear();
+            return true;
+        }
+        THECONVEYOR->force_queue();
+        THEKERNEL->call_event(ON_IDLE, this);
+    }
+
+    if(arc != nullptr) block->setup_arc(*arc, arc_start_steps, arc_steps_per_mm);
+    if(block->raster_pixels > 0) memcpy(block->raster(), THEROBOT->raster, block->raster_pixels);
 
-    // Max number of steps, for all axes
+    // Max number of steps, for all axes, and along the arc
     auto mi = std::max_element(block->steps.begin(), block->steps.end());
-    block->steps_event_count = *mi;
+    block->steps_event_count = std::max(*mi, block->arc_steps);
 
     block->millimeters = distance;
 
@@ -118,6 +221,10 @@ bool Planner::append_block( ActuatorCoordinates &actuator_pos, uint8_t n_motors,
     if( distance > 0.0F ) {
         block->nominal_speed = rate_mm_s;           // (mm/s) Always > 0
         block->nominal_rate = block->steps_event_count * rate_mm_s / distance; // (step/s) Always > 0
+        if(speed_override) {
+            block->speed_info()->max_speed = max_rate_mm_s;
+            block->speed_info()->programmed_speed = programmed_rate_mm_s;
+        }
     } else {
         block->nominal_speed = 0.0F;
         block->nominal_rate  = 0;
@@ -138,8 +245,8 @@ bool Planner::append_block( ActuatorCoordinates &actuator_pos, uint8_t n_motors,
     // from path, but used as a robust way to compute cornering speeds, as it takes into account the
     // nonlinearities of both the junction angle and junction velocity.
 
-    // NOTE however it does not take into account independent axis, in most cartesian X and Y and Z are totally independent
-    // and this allows one to stop with little to no decleration in many cases. This is particualrly bad on leadscrew based systems that will skip steps.
+    // NOTE on a cartesian X and Y and Z are totally independent, so the centripetal acceleration is limited by each axis acceleration
+    // instead of the block acceleration, see junction_acceleration()
     float vmax_junction = minimum_planner_speed; // Set default max junction speed
 
     // if unit_vec was null then it was not a primary axis move so we skip the junction deviation stuff
@@ -162,11 +269,14 @@ bool Planner::append_block( ActuatorCoordinates &actuator_pos, uint8_t n_motors,
             // Skip and use default max junction speed for 0 degree acute junction.
             if (cos_theta <= 0.9999F) {
                 vmax_junction = std::min(previous_nominal_speed, block->nominal_speed);
+                block->max_junction_speed = FLT_MAX;
                 // Skip and avoid divide by zero for straight junctions at 180 degrees. Limit to min() of nominal speeds.
                 if (cos_theta >= -0.9999F) {
                     // Compute maximum junction velocity based on maximum acceleration and junction deviation
                     float sin_theta_d2 = sqrtf(0.5F * (1.0F - cos_theta)); // Trig half angle identity. Always positive.
-                    vmax_junction = std::min(vmax_junction, sqrtf(acceleration * junction_deviation * sin_theta_d2 / (1.0F - sin_theta_d2)));
+                    float jacc = (this->per_axis_junction && THEROBOT->independent_axes) ? junction_acceleration(unit_vec, acceleration) : acceleration;
+                    block->max_junction_speed = sqrtf(jacc * junction_deviation * sin_theta_d2 / (1.0F - sin_theta_d2));
+                    vmax_junction = std::min(vmax_junction, block->max_junction_speed);
                 }
             }
         }
@@ -174,7 +284,7 @@ bool Planner::append_block( ActuatorCoordinates &actuator_pos, uint8_t n_motors,
     block->max_entry_speed = vmax_junction;
 
     // Initialize block entry speed. Compute based on deceleration to user-defined minimum_planner_speed.
-    float v_allowable = max_allowable_speed(-acceleration, minimum_planner_speed, block->millimeters);
+    float v_allowable = block->max_allowable_speed(minimum_planner_speed, block->millimeters);
     block->entry_speed = std::min(vmax_junction, v_allowable);
 
     // Initialize planner efficiency flags
@@ -192,14 +302,16 @@ bool Planner::append_block( ActuatorCoordinates &actuator_pos, uint8_t n_motors,
     block->recalculate_flag = true;
 
     // Update previous path unit_vector and nominal speed
-    if(unit_vec != nullptr) {
+    if(arc != nullptr) {
+        memcpy(previous_unit_vec, arc->exit_unit_vec, sizeof(previous_unit_vec));
+    } else if(unit_vec != nullptr) {
         memcpy(previous_unit_vec, unit_vec, sizeof(previous_unit_vec)); // previous_unit_vec[] = unit_vec[]
     } else {
         memset(previous_unit_vec, 0, sizeof(previous_unit_vec));
     }
 
     // Math-heavy re-computing of the whole queue to take the new
-    this->recalculate();
+    this->recalculate(THECONVEYOR->queue.head_i);
 
     // The block can now be used
     block->ready();
@@ -209,7 +321,8 @@ bool Planner::append_block( ActuatorCoordinates &actuator_pos, uint8_t n_motors,
     return true;
 }
 
-void Planner::recalculate()
+// head is the index of the newest block, the one being appended or the last one queued
+void Planner::recalculate(unsigned int head)
 {
     Conveyor::Queue_t &queue = THECONVEYOR->queue;
 
@@ -251,7 +364,7 @@ void Planner::recalculate()
 
     float entry_speed = minimum_planner_speed;
 
-    block_index = queue.head_i;
+    block_index = head;
     current     = queue.item_ref(block_index);
 
     if (!queue.is_empty()) {
@@ -273,7 +386,7 @@ void Planner::recalculate()
 
         float exit_speed = current->max_exit_speed();
 
-        while (block_index != queue.head_i) {
+        while (block_index != head) {
             previous    = current;
             block_index = queue.next(block_index);
             current     = queue.item_ref(block_index);
@@ -296,13 +409,59 @@ void Planner::recalculate()
     current->calculate_trapezoid(current->entry_speed, minimum_planner_speed);
 }
 
-
-// Calculates the maximum allowable speed at this point when you must be able to reach target_velocity using the
-// acceleration within the allotted distance.
-float Planner::max_allowable_speed(float acceleration, float target_velocity, float distance)
+// M220 changed the speed override, so the queued blocks the step ticker has not picked up yet are replanned at the new speed.
+// The step ticker has committed to the exit speed of the block it is running, so no block can be made slower than it can
+// decelerate to from there within the acceleration, a lower speed is reached over as many blocks as that takes.
+void Planner::set_speed_override(float factor)
 {
-    // Was acceleration*60*60*distance, in case this breaks, but here we prefer to use seconds instead of minutes
-    return(sqrtf(target_velocity * target_velocity - 2.0F * acceleration * distance));
-}
+    Conveyor::Queue_t &queue = THECONVEYOR->queue;
+
+    // the first block that is not being ticked is locked, the step ticker cannot take it or any after it until it is replanned
+    unsigned int first = queue.isr_tail_i;
+    Block *block = nullptr;
+    for (; first != queue.head_i; first = queue.next(first)) {
+        block = queue.item_ref(first);
+        if(block->is_ticking) continue;
+        block->locked = true;
+        if(!block->is_ticking) break;
+        block->locked = false; // the step ticker got it first
+    }
+    if(first == queue.head_i) return;
+
+    // the first block is entered at the exit speed of the block being ticked, or from rest
+    float min_speed = block->entry_speed;
+    const Block *previous = (first != queue.isr_tail_i) ? queue.item_ref(queue.prev(first)) : nullptr;
+    unsigned int last = first;
+    for (unsigned int i = first; i != queue.head_i; i = queue.next(i)) {
+        block = queue.item_ref(i);
+
+        const Block::speedinfo_t *si= block->speed_info();
+        if(si != nullptr) {
+            block->nominal_speed = std::max(std::min(si->programmed_speed * factor, si->max_speed), min_speed);
+            block->nominal_rate = block->steps_event_count * block->nominal_speed / block->millimeters;
+        }
+
+        // the junction speed is limited by the nominal speeds on each side of it
+        if(block->max_junction_speed > 0.0F) {
+            float vmax_junction = std::min(block->max_junction_speed, block->nominal_speed);
+            if(previous != nullptr) vmax_junction = std::min(vmax_junction, previous->nominal_speed);
+            block->max_entry_speed = std::max(vmax_junction, min_speed);
+        }
+
+        block->nominal_length_flag = block->nominal_speed <= block->max_allowable_speed(minimum_planner_speed, block->millimeters);
+        block->recalculate_flag = true;
+
+        // the slowest the next block can be entered at
+        min_speed = block->min_allowable_speed(min_speed, block->millimeters);
 
+        previous = block;
+        last = i;
+    }
+
+    this->recalculate(last);
+    queue.item_ref(first)->locked = false; // calculate_trapezoid() has already done this
+
+    // the step ticker may have wanted the first block while it was locked
+    if(THECONVEYOR->allow_fetch) THEKERNEL->step_ticker->prepare_next_block();
+}
 
@@ -9,24 +9,34 @@
 #define PLANNER_H
 
 #include "ActuatorCoordinates.h"
+#include "InputShaper.h"
 class Block;
+struct ArcPath;
 
 class Planner
 {
 public:
     Planner();
-    float max_allowable_speed( float acceleration, float target_velocity, float distance);
 
-    friend class Robot; // for acceleration, junction deviation, minimum_planner_speed
+    friend class Robot; // for acceleration, junction deviation, minimum_planner_speed, s_curve_jerk, input shaper, speed override
 
 private:
-    bool append_block(ActuatorCoordinates &target, uint8_t n_motors, float rate_mm_s, float distance, float unit_vec[], float accleration, float s_value, bool g123);
-    void recalculate();
+    float junction_acceleration(const float unit_vec[], float acceleration) const;
+    bool append_block(ActuatorCoordinates &target, uint8_t n_motors, float rate_mm_s, float max_rate_mm_s, float programmed_rate_mm_s, float distance, float unit_vec[], float accleration, float s_value, bool g123, const ArcPath *arc= nullptr);
+    void recalculate(unsigned int head);
+    void set_speed_override(float factor);
     void config_load();
+    void update_input_shapers();
     float previous_unit_vec[N_PRIMARY_AXIS];
     float junction_deviation;    // Setting
     float z_junction_deviation;  // Setting
     float minimum_planner_speed; // Setting
+    float s_curve_jerk;          // Setting, 0 is a trapezoid
+    bool per_axis_junction;      // Setting, limit the junction speed by each axis acceleration
+    uint8_t input_shaper_type;   // Setting, InputShaper::TYPE
+    float input_shaper_frequency[2]; // Setting, X and Y in Hz, 0 does not shape that axis
+    float input_shaper_damping[2];   // Setting, X and Y damping ratio
+    InputShaper input_shapers[4];    // for the blocks that move in X, Y and both
 };
 
 
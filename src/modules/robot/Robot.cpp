@@ -11,6 +11,7 @@
 #include "Robot.h"
 #include "Planner.h"
 #include "Conveyor.h"
+#include "Block.h"
 #include "Pin.h"
 #include "StepperMotor.h"
 #include "Gcode.h"
@@ -40,6 +41,7 @@
 #include "mri.h"
 
 #include <fastmath.h>
+#include <float.h>
 #include <string>
 #include <algorithm>
 
@@ -47,8 +49,12 @@
 #define  default_feed_rate_checksum          CHECKSUM("default_feed_rate")
 #define  mm_per_line_segment_checksum        CHECKSUM("mm_per_line_segment")
 #define  delta_segments_per_second_checksum  CHECKSUM("delta_segments_per_second")
+#define  mm_max_segment_error_checksum       CHECKSUM("mm_max_segment_error")
+#define  mm_min_segment_length_checksum      CHECKSUM("mm_min_segment_length")
 #define  mm_per_arc_segment_checksum         CHECKSUM("mm_per_arc_segment")
 #define  mm_max_arc_error_checksum           CHECKSUM("mm_max_arc_error")
+#define  mm_max_coalesce_error_checksum      CHECKSUM("mm_max_coalesce_error")
+#define  native_arcs_checksum                CHECKSUM("native_arcs")
 #define  arc_correction_checksum             CHECKSUM("arc_correction")
 #define  x_axis_max_speed_checksum           CHECKSUM("x_axis_max_speed")
 #define  y_axis_max_speed_checksum           CHECKSUM("y_axis_max_speed")
@@ -123,15 +129,19 @@ Robot::Robot()
     this->wcs_offsets.fill(wcs_t(0.0F, 0.0F, 0.0F));
     this->g92_offset = wcs_t(0.0F, 0.0F, 0.0F);
     this->next_command_is_MCS = false;
+    this->speed_override_move = false;
     this->disable_segmentation= false;
     this->disable_arm_solution= false;
     this->n_motors= 0;
+    this->coalesce_count= 0;
+    this->coalesce_time= 0;
 }
 
 //Called when the module has just been loaded
 void Robot::on_module_loaded()
 {
     this->register_for_event(ON_GCODE_RECEIVED);
+    this->register_for_event(ON_IDLE);
 
     // Configuration
     this->load_config();
@@ -153,6 +163,7 @@ void Robot::load_config()
     // To make adding those solution easier, they have their own, separate object.
     // Here we read the config to find out which arm solution to use
     if (this->arm_solution) delete this->arm_solution;
+    this->independent_axes= false;
     int solution_checksum = get_checksum(THEKERNEL->config->value(arm_solution_checksum)->by_default("cartesian")->as_string());
     // Note checksums are not const expressions when in debug mode, so don't use switch
     if(solution_checksum == hbot_checksum || solution_checksum == corexy_checksum) {
@@ -175,18 +186,24 @@ void Robot::load_config()
 
     } else if(solution_checksum == cartesian_checksum) {
         this->arm_solution = new CartesianSolution(THEKERNEL->config);
+        this->independent_axes= true;
 
     } else {
         this->arm_solution = new CartesianSolution(THEKERNEL->config);
+        this->independent_axes= true;
     }
 
     this->feed_rate           = THEKERNEL->config->value(default_feed_rate_checksum   )->by_default(  100.0F)->as_number();
     this->seek_rate           = THEKERNEL->config->value(default_seek_rate_checksum   )->by_default(  100.0F)->as_number();
     this->mm_per_line_segment = THEKERNEL->config->value(mm_per_line_segment_checksum )->by_default(    0.0F)->as_number();
     this->delta_segments_per_second = THEKERNEL->config->value(delta_segments_per_second_checksum )->by_default(0.0f   )->as_number();
+    this->mm_max_segment_error = THEKERNEL->config->value(mm_max_segment_error_checksum )->by_default(0.0f   )->as_number(); // disabled by default
+    this->mm_min_segment_length = THEKERNEL->config->value(mm_min_segment_length_checksum )->by_default(0.1f )->as_number();
     this->mm_per_arc_segment  = THEKERNEL->config->value(mm_per_arc_segment_checksum  )->by_default(    0.0f)->as_number();
     this->mm_max_arc_error    = THEKERNEL->config->value(mm_max_arc_error_checksum    )->by_default(   0.01f)->as_number();
+    this->mm_max_coalesce_error= THEKERNEL->config->value(mm_max_coalesce_error_checksum)->by_default(    0.0f)->as_number(); // disabled by default
     this->arc_correction      = THEKERNEL->config->value(arc_correction_checksum      )->by_default(    5   )->as_number();
+    this->native_arcs         = THEKERNEL->config->value(native_arcs_checksum         )->by_default(false )->as_bool(); // only used on cartesians
 
     // in mm/sec but specified in config as mm/min
     this->max_speeds[X_AXIS]  = THEKERNEL->config->value(x_axis_max_speed_checksum    )->by_default(60000.0F)->as_number() / 60.0F;
@@ -470,6 +487,9 @@ void Robot::on_gcode_received(void *argument)
 
     enum MOTION_MODE_T motion_mode= NONE;
 
+    // only G1 lines get merged, anything else has to see the pending line planned first
+    if(!(gcode->has_g && gcode->g == 1)) flush_coalesced_line();
+
     if( gcode->has_g) {
         switch( gcode->g ) {
             case 0:  motion_mode = SEEK;    break;
@@ -852,7 +872,7 @@ void Robot::on_gcode_received(void *argument)
                 }
                 break;
 
-            case 205: // M205 Xnnn - set junction deviation, Z - set Z junction deviation, Snnn - Set minimum planner speed
+            case 205: // M205 Xnnn - set junction deviation, Z - set Z junction deviation, Snnn - Set minimum planner speed, Jnnn - Set S-curve jerk
                 if (gcode->has_letter('X')) {
                     float jd = gcode->get_value('X');
                     // enforce minimum
@@ -874,6 +894,13 @@ void Robot::on_gcode_received(void *argument)
                         mps = 0.0F;
                     THEKERNEL->planner->minimum_planner_speed = mps;
                 }
+                if (gcode->has_letter('J')) {
+                    float j = gcode->get_value('J');
+                    // 0 disables it and uses trapezoids
+                    if (j < 0.0F)
+                        j = 0.0F;
+                    THEKERNEL->planner->s_curve_jerk = j;
+                }
                 break;
 
             case 211: // M211 Sn turns soft endstops on/off
@@ -906,7 +933,11 @@ void Robot::on_gcode_received(void *argument)
                     if (factor > 1000.0F)
                         factor = 1000.0F;
 
+                    // a line still being merged has the old speed
+                    flush_coalesced_line();
                     seconds_per_minute = 6000.0F / factor;
+                    // the moves that are already queued change speed too
+                    THEKERNEL->planner->set_speed_override(factor / 100.0F);
                 } else {
                     gcode->stream->printf("Speed factor at %6.2f %%\n", 6000.0F / seconds_per_minute);
                 }
@@ -935,7 +966,14 @@ void Robot::on_gcode_received(void *argument)
                 }
                 gcode->stream->printf("\n");
 
-                gcode->stream->printf(";X- Junction Deviation, Z- Z junction deviation, S - Minimum Planner speed mm/sec:\nM205 X%1.5f Z%1.5f S%1.5f\n", THEKERNEL->planner->junction_deviation, isnan(THEKERNEL->planner->z_junction_deviation)?-1:THEKERNEL->planner->z_junction_deviation, THEKERNEL->planner->minimum_planner_speed);
+                gcode->stream->printf(";X- Junction Deviation, Z- Z junction deviation, S - Minimum Planner speed mm/sec, J - S-curve jerk mm/sec^3:\nM205 X%1.5f Z%1.5f S%1.5f J%1.5f\n", THEKERNEL->planner->junction_deviation, isnan(THEKERNEL->planner->z_junction_deviation)?-1:THEKERNEL->planner->z_junction_deviation, THEKERNEL->planner->minimum_planner_speed, THEKERNEL->planner->s_curve_jerk);
+
+                if(THEKERNEL->planner->input_shaper_type != InputShaper::NONE) {
+                    gcode->stream->printf(";Input shaper F - frequency Hz, D - damping:\n");
+                    for (int i = X_AXIS; i <= Y_AXIS; ++i) {
+                        gcode->stream->printf("M593 %c F%1.2f D%1.3f\n", 'X'+i, THEKERNEL->planner->input_shaper_frequency[i], THEKERNEL->planner->input_shaper_damping[i]);
+                    }
+                }
 
                 gcode->stream->printf(";Max cartesian feedrates in mm/sec:\nM203 X%1.5f Y%1.5f Z%1.5f S%1.5f\n", this->max_speeds[X_AXIS], this->max_speeds[Y_AXIS], this->max_speeds[Z_AXIS], this->max_speed);
 
@@ -989,6 +1027,29 @@ void Robot::on_gcode_received(void *argument)
             }
             break;
 
+            case 593: { // M593 Fnnn set input shaper frequency, Dnnn set damping, for X or Y if given otherwise both
+                Planner *planner= THEKERNEL->planner;
+                if(gcode->has_letter('F') || gcode->has_letter('D')) {
+                    bool both= !gcode->has_letter('X') && !gcode->has_letter('Y');
+                    // the queued blocks use the current shapers
+                    THECONVEYOR->wait_for_idle();
+                    for (int i = X_AXIS; i <= Y_AXIS; ++i) {
+                        if(!both && !gcode->has_letter('X'+i)) continue;
+                        if(gcode->has_letter('F')) planner->input_shaper_frequency[i]= std::max(gcode->get_value('F'), 0.0F);
+                        if(gcode->has_letter('D')) planner->input_shaper_damping[i]= confine(gcode->get_value('D'), 0.0F, 0.99F);
+                    }
+                    planner->update_input_shapers();
+
+                }else{
+                    gcode->stream->printf("Input shaper %s", InputShaper::type_to_string(planner->input_shaper_type));
+                    for (int i = X_AXIS; i <= Y_AXIS; ++i) {
+                        gcode->stream->printf(", %c: %1.2f Hz damping %1.3f", 'X'+i, planner->input_shaper_frequency[i], planner->input_shaper_damping[i]);
+                    }
+                    gcode->stream->printf("\n");
+                }
+            }
+            break;
+
             case 665: { // M665 set optional arm solution variables based on arm solution.
                 // the parameter args could be any letter each arm solution only accepts certain ones
                 BaseSolution::arm_options_t options = gcode->get_args();
@@ -1025,10 +1086,12 @@ void Robot::on_gcode_received(void *argument)
 
     if( motion_mode != NONE) {
         is_g123= motion_mode != SEEK;
+        speed_override_move= true;
         process_move(gcode, motion_mode);
 
     }else{
         is_g123= false;
+        speed_override_move= false;
     }
 
     next_command_is_MCS = false; // must be on same line as G0 or G1
@@ -1071,18 +1134,7 @@ void Robot::process_move(Gcode *gcode, enum MOTION_MODE_T motion_mode)
 
     if(!next_command_is_MCS) {
         if(this->absolute_mode) {
-            // apply wcs offsets and g92 offset and tool offset
-            if(!isnan(param[X_AXIS])) {
-                target[X_AXIS]= param[X_AXIS] + std::get<X_AXIS>(wcs_offsets[current_wcs]) - std::get<X_AXIS>(g92_offset) + std::get<X_AXIS>(tool_offset);
-            }
-
-            if(!isnan(param[Y_AXIS])) {
-                target[Y_AXIS]= param[Y_AXIS] + std::get<Y_AXIS>(wcs_offsets[current_wcs]) - std::get<Y_AXIS>(g92_offset) + std::get<Y_AXIS>(tool_offset);
-            }
-
-            if(!isnan(param[Z_AXIS])) {
-                target[Z_AXIS]= param[Z_AXIS] + std::get<Z_AXIS>(wcs_offsets[current_wcs]) - std::get<Z_AXIS>(g92_offset) + std::get<Z_AXIS>(tool_offset);
-            }
+            wcs_to_machine(param, target);
 
         }else{
             // they are deltas from the machine_position if specified
@@ -1144,17 +1196,21 @@ void Robot::process_move(Gcode *gcode, enum MOTION_MODE_T motion_mode)
     if(gcode->has_letter('S')) s_value= gcode->get_value('S');
 
     bool moved= false;
+    uint8_t flags= gcode->has_letter('X') || gcode->has_letter('Y') ? LINE_XY : 0;
+    const char *error= nullptr;
 
     // Perform any physical actions
     switch(motion_mode) {
         case NONE: break;
 
         case SEEK:
-            moved= this->append_line(gcode, target, this->seek_rate / seconds_per_minute, delta_e );
+            moved= this->append_line(target, this->seek_rate / seconds_per_minute, delta_e, flags, nullptr, error);
             break;
 
         case LINEAR:
-            moved= this->append_line(gcode, target, this->feed_rate / seconds_per_minute, delta_e );
+            // a D parameter has the pixels of a raster line
+            moved= this->append_line(target, this->feed_rate / seconds_per_minute, delta_e, flags | LINE_FEED,
+                                     gcode->has_letter('D') ? strchr(gcode->get_command(), 'D') + 1 : nullptr, error);
             break;
 
         case CW_ARC:
@@ -1164,12 +1220,78 @@ void Robot::process_move(Gcode *gcode, enum MOTION_MODE_T motion_mode)
             break;
     }
 
+    if(error != nullptr) {
+        gcode->is_error= true;
+        gcode->txt_after_ok= error;
+    }
+
     if(moved) {
         // set machine_position to the calculated target
         memcpy(machine_position, target, n_motors*sizeof(float));
     }
 }
 
+// apply the wcs offsets, g92 offset and tool offset to the XYZ of param that are not NAN to get the machine coordinate target
+void Robot::wcs_to_machine(const float param[], float target[]) const
+{
+    if(!isnan(param[X_AXIS])) {
+        target[X_AXIS]= param[X_AXIS] + std::get<X_AXIS>(wcs_offsets[current_wcs]) - std::get<X_AXIS>(g92_offset) + std::get<X_AXIS>(tool_offset);
+    }
+
+    if(!isnan(param[Y_AXIS])) {
+        target[Y_AXIS]= param[Y_AXIS] + std::get<Y_AXIS>(wcs_offsets[current_wcs]) - std::get<Y_AXIS>(g92_offset) + std::get<Y_AXIS>(tool_offset);
+    }
+
+    if(!isnan(param[Z_AXIS])) {
+        target[Z_AXIS]= param[Z_AXIS] + std::get<Z_AXIS>(wcs_offsets[current_wcs]) - std::get<Z_AXIS>(g92_offset) + std::get<Z_AXIS>(tool_offset);
+    }
+}
+
+// an absolute G0 or G1 in millimeters that does not come from a Gcode, used by the binary protocol
+// param is in the current WCS for XYZ and machine coordinates for ABC, an axis that is NAN does not move
+// rate in mm/min and s are modal like F and S, NAN leaves them as they are. returns the error or nullptr
+const char *Robot::append_move(const float param[], float rate, float s, bool linear)
+{
+    // only G1 lines get merged, anything else has to see the pending line planned first
+    if(!linear) flush_coalesced_line();
+
+    float target[n_motors];
+    memcpy(target, machine_position, n_motors*sizeof(float));
+    wcs_to_machine(param, target);
+    #if MAX_ROBOT_ACTUATORS > 3
+    for (int i = A_AXIS; i < n_motors; ++i) {
+        if(!isnan(param[i])) target[i]= param[i];
+    }
+    #endif
+
+    if(!isnan(rate)) {
+        if(linear) feed_rate= rate;
+        else seek_rate= rate;
+    }
+    if(!isnan(s)) s_value= s;
+
+    uint8_t flags= (linear ? LINE_FEED : 0) | (isnan(param[X_AXIS]) && isnan(param[Y_AXIS]) ? 0 : LINE_XY);
+    const char *error= nullptr;
+
+    is_g123= linear;
+    speed_override_move= true;
+    bool moved= append_line(target, (linear ? feed_rate : seek_rate) / seconds_per_minute, NAN, flags, nullptr, error);
+    is_g123= false;
+    speed_override_move= false;
+
+    if(moved) memcpy(machine_position, target, n_motors*sizeof(float));
+    return error;
+}
+
+// if the queue has run dry the step ticker would be waiting for a line that is being merged, so plan it now
+// and do not wait for that if the lines stop coming, the queue would run dry before the pending line gets planned
+void Robot::on_idle(void *argument)
+{
+    if(coalesce_count > 0 && (THECONVEYOR->is_queue_empty() || us_ticker_read() - coalesce_time >= coalesce_timeout_ms * 1000)) {
+        flush_coalesced_line();
+    }
+}
+
 // reset the machine position for all axis. Used for homing.
 // after homing we supply the cartesian coordinates that the head is at when homed,
 // however for Z this is the compensated machine position (if enabled)
@@ -1227,6 +1349,9 @@ void Robot::reset_actuator_position(const ActuatorCoordinates &ac)
 // TODO maybe we should only reset axis that are being homed unless this is due to a ON_HALT
 void Robot::reset_position_from_current_actuator_position()
 {
+    // this is called on a halt so any line still being merged is dropped
+    drop_coalesced_line();
+
     ActuatorCoordinates actuator_pos;
     for (size_t i = X_AXIS; i < n_motors; i++) {
         // NOTE actuator::current_position is curently NOT the same as actuator::machine_position after an abrupt abort
@@ -1263,17 +1388,23 @@ void Robot::reset_position_from_current_actuator_position()
 // Convert target (in machine coordinates) to machine_position, then convert to actuator position and append this to the planner
 // target is in machine coordinates without the compensation transform, however we save a compensated_machine_position that includes
 // all transforms and is what we actually convert to actuator positions
-bool Robot::append_milestone(const float target[], float rate_mm_s)
+// if arc is set the plane axes follow that arc to the target instead of the straight line, the rest of it is filled in here
+// if transformed and actuator_target are set the target has already been compensated and converted by flush_milestones()
+bool Robot::append_milestone(const float target[], float rate_mm_s, ArcPath *arc, const float *transformed, const ActuatorCoordinates *actuator_target)
 {
     float deltas[n_motors];
     float transformed_target[n_motors]; // adjust target for bed compensation
     float unit_vec[N_PRIMARY_AXIS];
 
+    // so M220 can change the speed once this is queued, the rate without the speed override and the fastest the speed limits allow
+    float programmed_rate_mm_s= speed_override_move ? rate_mm_s * seconds_per_minute / 60.0F : 0.0F;
+    float max_rate_mm_s= FLT_MAX;
+
     // unity transform by default
-    memcpy(transformed_target, target, n_motors*sizeof(float));
+    memcpy(transformed_target, transformed != nullptr ? transformed : target, n_motors*sizeof(float));
 
     // check function pointer and call if set to transform the target to compensate for bed
-    if(compensationTransform) {
+    if(compensationTransform && transformed == nullptr) {
         // some compensation strategies can transform XYZ, some just change Z
         compensationTransform(transformed_target, false);
     }
@@ -1346,6 +1477,33 @@ bool Robot::append_milestone(const float target[], float rate_mm_s)
     // as the last milestone won't be updated we do not actually lose any moves as they will be accounted for in the next move
     if(!auxilliary_move && distance < 0.00001F) return false;
 
+    // for an arc the distance is along the arc, and the most each plane axis moves per mm of that is where it is most
+    // in the direction of travel, which is at one end as the arc never goes past where either axis changes direction
+    float arc_radius= 0, arc_length= 0;
+    float arc_axis_ratio[2];
+    if(arc != nullptr) {
+        for (int k = 0; k < 2; ++k) {
+            arc->start[k]= compensated_machine_position[arc->axis[k]] - arc->center[k];
+            arc->end[k]= transformed_target[arc->axis[k]] - arc->center[k];
+            sos -= powf(deltas[arc->axis[k]], 2);
+        }
+        arc_radius= hypotf(arc->start[0], arc->start[1]);
+        arc_length= fabsf(arc->angle) * arc_radius;
+        distance= sqrtf(arc_length * arc_length + std::max(sos, 0.0F));
+
+        // the direction at each end, positive angles turn from axis 0 towards axis 1
+        float dir= (arc->angle > 0 ? 1.0F : -1.0F) * arc_length / (arc_radius * distance);
+        memcpy(arc->exit_unit_vec, deltas, sizeof(arc->exit_unit_vec));
+        for (int i = 0; i < N_PRIMARY_AXIS; ++i) arc->exit_unit_vec[i] /= distance;
+        arc->exit_unit_vec[arc->axis[0]]= -arc->end[1] * dir;
+        arc->exit_unit_vec[arc->axis[1]]= arc->end[0] * dir;
+        deltas[arc->axis[0]]= -arc->start[1] * dir * distance;
+        deltas[arc->axis[1]]= arc->start[0] * dir * distance;
+        for (int k = 0; k < 2; ++k) {
+            arc_axis_ratio[k]= std::max(fabsf(deltas[arc->axis[k]]) / distance, fabsf(arc->exit_unit_vec[arc->axis[k]]));
+        }
+    }
+
     if(!auxilliary_move) {
          for (size_t i = X_AXIS; i < N_PRIMARY_AXIS; i++) {
             // find distance unit vector for primary axis only
@@ -1354,20 +1512,27 @@ bool Robot::append_milestone(const float target[], float rate_mm_s)
             // Do not move faster than the configured cartesian limits for XYZ
             if ( i <= Z_AXIS && max_speeds[i] > 0 ) {
                 float axis_speed = fabsf(unit_vec[i] * rate_mm_s);
+                if(arc != nullptr && i == arc->axis[0]) axis_speed = arc_axis_ratio[0] * rate_mm_s;
+                if(arc != nullptr && i == arc->axis[1]) axis_speed = arc_axis_ratio[1] * rate_mm_s;
 
+                if(axis_speed > 0.0F) max_rate_mm_s= std::min(max_rate_mm_s, rate_mm_s * max_speeds[i] / axis_speed);
                 if (axis_speed > max_speeds[i])
                     rate_mm_s *= ( max_speeds[i] / axis_speed );
             }
         }
 
-        if(this->max_speed > 0 && rate_mm_s > this->max_speed) {
-            rate_mm_s= this->max_speed;
+        if(this->max_speed > 0) {
+            max_rate_mm_s= std::min(max_rate_mm_s, this->max_speed);
+            if(rate_mm_s > this->max_speed) rate_mm_s= this->max_speed;
         }
     }
 
     // find actuator position given the machine position, use actual adjusted target
     ActuatorCoordinates actuator_pos;
-    if(!disable_arm_solution) {
+    if(actuator_target != nullptr) {
+        actuator_pos= *actuator_target;
+
+    }else if(!disable_arm_solution) {
         arm_solution->cartesian_to_actuator( transformed_target, actuator_pos );
         // some arm solutions can indicate a halt if the calcs go bad
         if(THEKERNEL->is_halted()) return false;
@@ -1413,8 +1578,11 @@ bool Robot::append_milestone(const float target[], float rate_mm_s)
     for (size_t actuator = 0; actuator < n_motors; actuator++) {
         float d = fabsf(actuator_pos[actuator] - actuators[actuator]->get_last_milestone());
         if(d < 0.00001F || !actuators[actuator]->is_selected()) continue; // no realistic movement for this actuator
+        if(arc != nullptr && actuator == arc->axis[0]) d = arc_axis_ratio[0] * distance;
+        if(arc != nullptr && actuator == arc->axis[1]) d = arc_axis_ratio[1] * distance;
 
         float actuator_rate= d * isecs;
+        max_rate_mm_s= std::min(max_rate_mm_s, rate_mm_s * actuators[actuator]->get_max_rate() / actuator_rate);
         if (actuator_rate > actuators[actuator]->get_max_rate()) {
             rate_mm_s *= (actuators[actuator]->get_max_rate() / actuator_rate);
             isecs = rate_mm_s / distance;
@@ -1435,6 +1603,14 @@ bool Robot::append_milestone(const float target[], float rate_mm_s)
         }
     }
 
+    // going round an arc needs a centripetal acceleration, keep it within the acceleration
+    if(arc != nullptr) {
+        float arc_speed = rate_mm_s * arc_length / distance;
+        float max_arc_speed = sqrtf(acceleration * arc_radius);
+        max_rate_mm_s= std::min(max_rate_mm_s, rate_mm_s * max_arc_speed / arc_speed);
+        if(arc_speed > max_arc_speed) rate_mm_s *= max_arc_speed / arc_speed;
+    }
+
     // if we are in feed hold wait here until it is released, this means that even segmented lines will pause
     while(THEKERNEL->get_feed_hold()) {
         THEKERNEL->call_event(ON_IDLE, this);
@@ -1445,7 +1621,7 @@ bool Robot::append_milestone(const float target[], float rate_mm_s)
     // Append the block to the planner
     // NOTE that distance here should be either the distance travelled by the XYZ axis, or the E mm travel if a solo E move
     // NOTE this call will bock until there is room in the block queue, on_idle will continue to be called
-    if(THEKERNEL->planner->append_block( actuator_pos, n_motors, rate_mm_s, distance, auxilliary_move ? nullptr : unit_vec, acceleration, s_value, is_g123)) {
+    if(THEKERNEL->planner->append_block( actuator_pos, n_motors, rate_mm_s, max_rate_mm_s, programmed_rate_mm_s, distance, auxilliary_move ? nullptr : unit_vec, acceleration, s_value, is_g123, arc)) {
         // this is the new compensated machine position
         memcpy(this->compensated_machine_position, transformed_target, n_motors*sizeof(float));
         return true;
@@ -1465,6 +1641,9 @@ bool Robot::delta_move(const float *delta, float rate_mm_s, uint8_t naxis)
         return false;
     }
 
+    // this move follows any line that is still being merged
+    flush_coalesced_line();
+
     // get the absolute target position, default is current machine_position
     float target[n_motors];
     memcpy(target, machine_position, n_motors*sizeof(float));
@@ -1475,6 +1654,7 @@ bool Robot::delta_move(const float *delta, float rate_mm_s, uint8_t naxis)
     }
 
     is_g123= false; // we don't want the laser to fire
+    speed_override_move= false;
     // submit for planning and if moved update machine_position
     if(append_milestone(target, rate_mm_s)) {
          memcpy(machine_position, target, n_motors*sizeof(float));
@@ -1485,12 +1665,12 @@ bool Robot::delta_move(const float *delta, float rate_mm_s, uint8_t naxis)
 }
 
 // Append a move to the queue ( cutting it into segments if needed )
-bool Robot::append_line(Gcode *gcode, const float target[], float rate_mm_s, float delta_e)
+// flags are LINE_FLAGS, raster_data is the hex pixels of a raster line or nullptr, error is set if the line is not valid
+bool Robot::append_line(const float target[], float rate_mm_s, float delta_e, uint8_t flags, const char *raster_data, const char *&error)
 {
     // catch negative or zero feed rates and return the same error as GRBL does
     if(rate_mm_s <= 0.0F) {
-        gcode->is_error= true;
-        gcode->txt_after_ok= (rate_mm_s == 0 ? "Undefined feed rate" : "feed rate < 0");
+        error= (rate_mm_s == 0 ? "Undefined feed rate" : "feed rate < 0");
         return false;
     }
 
@@ -1499,6 +1679,7 @@ bool Robot::append_line(Gcode *gcode, const float target[], float rate_mm_s, flo
 
     if(millimeters_of_travel < 0.00001F) {
         // we have no movement in XYZ, probably E only extrude or retract
+        flush_coalesced_line();
         return this->append_milestone(target, rate_mm_s);
     }
 
@@ -1508,26 +1689,215 @@ bool Robot::append_line(Gcode *gcode, const float target[], float rate_mm_s, flo
         We ask Extruder to do all the work but we need to pass in the relevant data.
         NOTE we need to do this before we segment the line (for deltas)
     */
-    if(!isnan(delta_e) && gcode->has_g && gcode->g == 1) {
+    if(!isnan(delta_e) && (flags & LINE_FEED)) {
         float data[2]= {delta_e, rate_mm_s / millimeters_of_travel};
         if(PublicData::set_value(extruder_checksum, target_checksum, data)) {
             rate_mm_s *= data[1]; // adjust the feedrate
         }
     }
 
+    bool segment= !(this->disable_segmentation || (!segment_z_moves && !(flags & LINE_XY)));
+
+    bool moved;
+    if(raster_data != nullptr) {
+        flush_coalesced_line();
+        moved= append_raster_line(raster_data, target, rate_mm_s, error);
+
+    }else if(this->mm_max_coalesce_error > 0.0F && (flags & LINE_FEED)) {
+        // try to merge it with the previous lines, it is planned later
+        moved= coalesce_line(target, rate_mm_s, segment);
+
+    }else{
+        flush_coalesced_line();
+        moved= append_segmented_line(machine_position, target, rate_mm_s, segment);
+    }
+
+    return moved;
+}
+
+// Merge consecutive G1 lines into one line as long as the points they go through stay within mm_max_coalesce_error of it
+// CAM and slicers can output long runs of tiny nearly collinear lines, this saves planning each of them as a block
+bool Robot::coalesce_line(const float target[], float rate_mm_s, bool segment)
+{
+    if(coalesce_count > 0) {
+        if(rate_mm_s == coalesce_rate && s_value == coalesce_s_value && segment == coalesce_segment &&
+           coalesce_count < max_coalesce && can_coalesce(target)) {
+            // extend the pending line to the new target
+            memcpy(coalesce_points[coalesce_count++], target, n_motors*sizeof(float));
+            coalesce_time= us_ticker_read();
+            return true;
+        }
+
+        // does not fit so plan what we have and start again with this line
+        flush_coalesced_line();
+    }
+
+    memcpy(coalesce_start, machine_position, n_motors*sizeof(float));
+    memcpy(coalesce_points[0], target, n_motors*sizeof(float));
+    coalesce_rate= rate_mm_s;
+    coalesce_s_value= s_value;
+    coalesce_segment= segment;
+    coalesce_count= 1;
+    coalesce_time= us_ticker_read();
+    return true;
+}
+
+// see if all the points of the pending line are within mm_max_coalesce_error of the line from its start to target
+bool Robot::can_coalesce(const float target[]) const
+{
+    float chord[n_motors];
+    float sos= 0;
+    for (int i = 0; i < n_motors; ++i) {
+        chord[i]= target[i] - coalesce_start[i];
+        if(i < N_PRIMARY_AXIS) sos += chord[i] * chord[i];
+    }
+    if(sos < 1e-10F) return false;
+
+    float max_error2= mm_max_coalesce_error * mm_max_coalesce_error;
+    float last_t= 0;
+    for (int j = 0; j < coalesce_count; ++j) {
+        const float *p= coalesce_points[j];
+
+        // how far along the chord this point is, it must keep moving forward
+        float dot= 0, len2= 0;
+        for (int i = 0; i < N_PRIMARY_AXIS; ++i) {
+            float d= p[i] - coalesce_start[i];
+            dot += d * chord[i];
+            len2 += d * d;
+        }
+        float t= dot / sos;
+        if(t <= last_t || t >= 1.0F) return false;
+        last_t= t;
+
+        // distance from the chord
+        if(len2 - dot * t > max_error2) return false;
+
+        // the other axis (eg E) are interpolated along the chord so they must be close to where they would be
+        for (int i = N_PRIMARY_AXIS; i < n_motors; ++i) {
+            if(fabsf(p[i] - (coalesce_start[i] + chord[i] * t)) > mm_max_coalesce_error) return false;
+        }
+    }
+
+    return true;
+}
+
+// plan the line that is being merged, this has to be done before anything else is planned or the queue is waited on
+void Robot::flush_coalesced_line()
+{
+    if(coalesce_count == 0) return;
+
+    // clear it first as planning can call on_idle
+    uint8_t n= coalesce_count;
+    coalesce_count= 0;
+
+    // the line has to be planned with the modal state that was in effect when it was received
+    bool g123= is_g123;
+    bool speed_override= speed_override_move;
+    float s= s_value;
+    is_g123= true;
+    speed_override_move= true;
+    s_value= coalesce_s_value;
+
+    append_segmented_line(coalesce_start, coalesce_points[n-1], coalesce_rate, coalesce_segment);
+
+    is_g123= g123;
+    speed_override_move= speed_override;
+    s_value= s;
+}
+
+// Add a segment end to the batch, once the batch is full it is converted and appended to the queue
+bool Robot::batch_milestone(milestone_batch_t& batch, const float target[], float rate_mm_s)
+{
+    memcpy(batch.target[batch.n++], target, n_motors*sizeof(float));
+    if(batch.n < milestone_batch_size) return false;
+    return flush_milestones(batch, rate_mm_s);
+}
+
+// Convert the first n segment ends in the batch to actuator positions with one call to the arm solution
+// returns false if the arm solution halted
+bool Robot::convert_milestones(milestone_batch_t& batch, uint8_t n)
+{
+    for (uint8_t i = 0; i < n; ++i) {
+        memcpy(batch.transformed[i], batch.target[i], n_motors*sizeof(float));
+        if(compensationTransform) compensationTransform(batch.transformed[i], false);
+    }
+
+    if(!disable_arm_solution) {
+        arm_solution->cartesian_to_actuators(batch.transformed[0], k_max_actuators, batch.actuator_pos, n);
+        // some arm solutions can indicate a halt if the calcs go bad
+        if(THEKERNEL->is_halted()) return false;
+
+    }else{
+        for (uint8_t i = 0; i < n; ++i) {
+            for (size_t j = X_AXIS; j <= Z_AXIS; j++) {
+                batch.actuator_pos[i][j] = batch.transformed[i][j];
+            }
+        }
+    }
+
+    return true;
+}
+
+// Convert all the segment ends in the batch to actuator positions with one call to the arm solution, then append them to the queue
+bool Robot::flush_milestones(milestone_batch_t& batch, float rate_mm_s)
+{
+    uint8_t n= batch.n;
+    batch.n= 0;
+    if(!convert_milestones(batch, n)) return false;
+
+    bool moved= false;
+    for (uint8_t i = 0; i < n; ++i) {
+        if(THEKERNEL->is_halted()) return false; // don't queue any more segments
+        if(this->append_milestone(batch.target[i], rate_mm_s, nullptr, batch.transformed[i], &batch.actuator_pos[i])) moved= true;
+    }
+
+    return moved;
+}
+
+// Append a G1 with a D parameter, D is followed by two lowercase hex digits for the power of each pixel along the line (00 to ff scale S)
+// eg G1 X10 S1 D00407fbfff, the pixels are spread evenly along the move which is a single block so the laser can find the pixel
+// from the steps done, so it is not segmented (deltas and scaras are not supported). data is what follows the D
+bool Robot::append_raster_line(const char *data, const float target[], float rate_mm_s, const char *&error)
+{
+    uint8_t pixels[Block::max_raster_pixels];
+    uint16_t n= parse_hex_bytes(data, pixels, Block::max_raster_pixels);
+    const char *p= data + 2 * n;
+
+    if(n == 0 || isxdigit(*p) || !this->independent_axes) {
+        error= n == 0 ? "No raster data" : isxdigit(*p) ? "Too much raster data" : "Raster lines need a cartesian arm solution";
+        return false;
+    }
+
+    raster= pixels;
+    raster_pixels= n;
+    bool moved= this->append_milestone(target, rate_mm_s);
+    raster= nullptr;
+    raster_pixels= 0;
+
+    return moved;
+}
+
+// Append a line from start to target to the queue ( cutting it into segments if needed )
+bool Robot::append_segmented_line(const float start[], const float target[], float rate_mm_s, bool segment)
+{
     // We cut the line into smaller segments. This is only needed on a cartesian robot for zgrid, but always necessary for robots with rotational axes like Deltas.
     // In delta robots either mm_per_line_segment can be used OR delta_segments_per_second
     // The latter is more efficient and avoids splitting fast long lines into very small segments, like initial z move to 0, it is what Johanns Marlin delta port does
+    // if mm_max_segment_error is set it overrides both and the segments are only as short as the arm solution needs
     uint16_t segments;
 
-    if(this->disable_segmentation || (!segment_z_moves && !gcode->has_letter('X') && !gcode->has_letter('Y'))) {
+    if(!segment) {
         segments= 1;
 
+    } else if(this->mm_max_segment_error > 0.0F && !this->independent_axes) {
+        return append_adaptive_line(start, target, rate_mm_s);
+
     } else if(this->delta_segments_per_second > 1.0F) {
         // enabled if set to something > 1, it is set to 0.0 by default
         // segment based on current speed and requested segments per second
         // the faster the travel speed the fewer segments needed
         // NOTE rate is mm/sec and we take into account any speed override
+        float millimeters_of_travel = sqrtf(powf( target[X_AXIS] - start[X_AXIS], 2 ) +  powf( target[Y_AXIS] - start[Y_AXIS], 2 ) +  powf( target[Z_AXIS] - start[Z_AXIS], 2 ));
         float seconds = millimeters_of_travel / rate_mm_s;
         segments = max(1.0F, ceilf(this->delta_segments_per_second * seconds));
         // TODO if we are only moving in Z on a delta we don't really need to segment at all
@@ -1536,44 +1906,143 @@ bool Robot::append_line(Gcode *gcode, const float target[], float rate_mm_s, flo
         if(this->mm_per_line_segment == 0.0F) {
             segments = 1; // don't split it up
         } else {
+            float millimeters_of_travel = sqrtf(powf( target[X_AXIS] - start[X_AXIS], 2 ) +  powf( target[Y_AXIS] - start[Y_AXIS], 2 ) +  powf( target[Z_AXIS] - start[Z_AXIS], 2 ));
             segments = ceilf( millimeters_of_travel / this->mm_per_line_segment);
         }
     }
 
+    if(segments == 1) return this->append_milestone(target, rate_mm_s);
+
     bool moved= false;
-    if (segments > 1) {
-        // A vector to keep track of the endpoint of each segment
-        float segment_delta[n_motors];
-        float segment_end[n_motors];
-        memcpy(segment_end, machine_position, n_motors*sizeof(float));
-
-        // How far do we move each segment?
-        for (int i = 0; i < n_motors; i++)
-            segment_delta[i] = (target[i] - machine_position[i]) / segments;
-
-        // segment 0 is already done - it's the end point of the previous move so we start at segment 1
-        // We always add another point after this loop so we stop at segments-1, ie i < segments
-        for (int i = 1; i < segments; i++) {
-            if(THEKERNEL->is_halted()) return false; // don't queue any more segments
-            for (int j = 0; j < n_motors; j++)
-                segment_end[j] += segment_delta[j];
+    milestone_batch_t batch;
+
+    // A vector to keep track of the endpoint of each segment
+    float segment_delta[n_motors];
+    float segment_end[n_motors];
+    memcpy(segment_end, start, n_motors*sizeof(float));
+
+    // How far do we move each segment?
+    for (int i = 0; i < n_motors; i++)
+        segment_delta[i] = (target[i] - start[i]) / segments;
+
+    // segment 0 is already done - it's the end point of the previous move so we start at segment 1
+    // We always add another point after this loop so we stop at segments-1, ie i < segments
+    for (int i = 1; i < segments; i++) {
+        if(THEKERNEL->is_halted()) return false; // don't queue any more segments
+        for (int j = 0; j < n_motors; j++)
+            segment_end[j] += segment_delta[j];
+
+        // Append the end of this segment to the queue
+        // this can block waiting for free block queue or if in feed hold
+        if(batch_milestone(batch, segment_end, rate_mm_s)) moved= true;
+    }
+
+    // Append the end of this full move to the queue
+    if(batch_milestone(batch, target, rate_mm_s)) moved= true;
+    if(flush_milestones(batch, rate_mm_s)) moved= true;
+
+    return moved;
+}
+
+
+// how far the path the effector takes from a to b is from the straight line, when the actuators move in proportion to each other
+// as they do in a block, it is checked at the quarter points. a and b are after the compensation transform and already converted
+float Robot::segment_error(const float a[], const ActuatorCoordinates& actuator_a, const float b[], const ActuatorCoordinates& actuator_b) const
+{
+    ActuatorCoordinates actuator_pos= actuator_a;
+
+    float v[3], vv= 0;
+    for (int i = X_AXIS; i <= Z_AXIS; ++i) {
+        v[i]= b[i] - a[i];
+        vv += v[i] * v[i];
+    }
 
-            // Append the end of this segment to the queue
-            // this can block waiting for free block queue or if in feed hold
-            bool b= this->append_milestone(segment_end, rate_mm_s);
-            moved= moved || b;
+    float max_error2= 0;
+    for (int q = 1; q < 4; ++q) {
+        for (int i = X_AXIS; i <= Z_AXIS; ++i) {
+            actuator_pos[i]= actuator_a[i] + (actuator_b[i] - actuator_a[i]) * q / 4;
         }
+        float p[3];
+        arm_solution->actuator_to_cartesian(actuator_pos, p);
+
+        // distance of p from the line
+        float ww= 0, wv= 0;
+        for (int i = X_AXIS; i <= Z_AXIS; ++i) {
+            float w= p[i] - a[i];
+            ww += w * w;
+            wv += w * v[i];
+        }
+        float e2= (vv > 0) ? ww - wv * wv / vv : ww;
+        if(e2 > max_error2) max_error2= e2;
+    }
+
+    return sqrtf(max_error2);
+}
+
+// Append a line on a delta or scara cut into segments that are each within mm_max_segment_error of the line, so they are long
+// where the arm solution is close to linear and only short where it is not. Each segment starts out twice as long as the last
+// one and is halved until it is close enough, but not below mm_min_segment_length however far out it is, eg near a singularity
+bool Robot::append_adaptive_line(const float start[], const float target[], float rate_mm_s)
+{
+    float millimeters_of_travel = sqrtf(powf( target[X_AXIS] - start[X_AXIS], 2 ) +  powf( target[Y_AXIS] - start[Y_AXIS], 2 ) +  powf( target[Z_AXIS] - start[Z_AXIS], 2 ));
+
+    // the candidate ends of a segment are converted a few at a time with one call to the arm solution, the one that is taken is
+    // appended as it is and becomes the start of the next segment, so every point is only converted once
+    static const uint8_t n_trials= 4;
+    milestone_batch_t trials;
+    float lengths[n_trials];
+    memcpy(trials.target[0], start, n_motors*sizeof(float));
+    if(!convert_milestones(trials, 1)) return false;
+    float segment_start[n_motors];
+    ActuatorCoordinates actuator_start= trials.actuator_pos[0];
+    memcpy(segment_start, trials.transformed[0], n_motors*sizeof(float));
+
+    bool moved= false;
+    float done= 0;
+    float length= millimeters_of_travel;
+    while(millimeters_of_travel - done > this->mm_min_segment_length) {
+        if(THEKERNEL->is_halted()) return false; // don't queue any more segments
+
+        length= std::min(length, millimeters_of_travel - done);
+        uint8_t n, k;
+        for(;;) {
+            // the next candidates, each half as long as the one before, the shortest one is always taken
+            for (n = 0; n < n_trials; ++n) {
+                lengths[n]= length;
+                float f= (done + length) / millimeters_of_travel;
+                for (int i = 0; i < n_motors; i++)
+                    trials.target[n][i] = start[i] + (target[i] - start[i]) * f;
+                if(length <= this->mm_min_segment_length) { ++n; break; }
+                length= std::max(length / 2, this->mm_min_segment_length);
+            }
+            if(!convert_milestones(trials, n)) return false;
+
+            for (k = 0; k < n; ++k) {
+                if(lengths[k] <= this->mm_min_segment_length ||
+                   segment_error(segment_start, actuator_start, trials.transformed[k], trials.actuator_pos[k]) <= this->mm_max_segment_error) break;
+            }
+            if(k < n) break;
+        }
+
+        length= lengths[k];
+        done += length;
+        if(millimeters_of_travel - done <= this->mm_min_segment_length) break; // the rest is done by the last one
+
+        // Append the end of this segment to the queue
+        // this can block waiting for free block queue or if in feed hold
+        bool b= this->append_milestone(trials.target[k], rate_mm_s, nullptr, trials.transformed[k], &trials.actuator_pos[k]);
+        moved= moved || b;
+        memcpy(segment_start, trials.transformed[k], n_motors*sizeof(float));
+        actuator_start= trials.actuator_pos[k];
+        length *= 2;
     }
 
     // Append the end of this full move to the queue
     if(this->append_milestone(target, rate_mm_s)) moved= true;
 
-    this->next_command_is_MCS = false; // always reset this
-
     return moved;
 }
 
-
 // Append an arc to the queue ( cutting it into segments as needed )
 // TODO does not support any E parameters so cannot be used for 3D printing.
 bool Robot::append_arc(Gcode * gcode, const float target[], const float offset[], float radius, bool is_clockwise )
@@ -1623,6 +2092,15 @@ bool Robot::append_arc(Gcode * gcode, const float target[], const float offset[]
         return false;
     }
 
+    // on a cartesian the arc can be stepped directly, unless it is so small the plane axes only move a few steps
+    // or the target is not on the circle (a small difference from rounding in the gcode is fine)
+    if(this->native_arcs && this->independent_axes && !compensationTransform && !disable_arm_solution &&
+       radius * std::min(actuators[this->plane_axis_0]->get_steps_per_mm(), actuators[this->plane_axis_1]->get_steps_per_mm()) >= 4.0F &&
+       fabsf(hypotf(rt_axis0, rt_axis1) - radius) <= 0.005F + 0.001F * radius) {
+        float center[2]= {center_axis0, center_axis1};
+        return append_native_arc(target, center, angular_travel, rate_mm_s);
+    }
+
     // limit segments by maximum arc error
     float arc_segment = this->mm_per_arc_segment;
     if ((this->mm_max_arc_error > 0) && (2 * radius > this->mm_max_arc_error)) {
@@ -1641,6 +2119,7 @@ bool Robot::append_arc(Gcode * gcode, const float target[], const float offset[]
     // TODO for deltas we need to make sure we are at least as many segments as requested, also if mm_per_line_segment is set we need to use the
     uint16_t segments = floorf(millimeters_of_travel / arc_segment);
     bool moved= false;
+    milestone_batch_t batch;
 
     if(segments > 1) {
         float theta_per_segment = angular_travel / segments;
@@ -1712,13 +2191,68 @@ bool Robot::append_arc(Gcode * gcode, const float target[], const float offset[]
             arc_target[this->plane_axis_2] += linear_per_segment;
 
             // Append this segment to the queue
-            bool b= this->append_milestone(arc_target, rate_mm_s);
-            moved= moved || b;
+            if(batch_milestone(batch, arc_target, rate_mm_s)) moved= true;
         }
     }
 
     // Ensure last segment arrives at target location.
-    if(this->append_milestone(target, rate_mm_s)) moved= true;
+    if(batch_milestone(batch, target, rate_mm_s)) moved= true;
+    if(flush_milestones(batch, rate_mm_s)) moved= true;
+
+    return moved;
+}
+
+// Append an arc that is stepped directly, it is split where either plane axis changes direction so each block
+// only turns through a quarter of the circle at most, and each block keeps the direction of its motors
+bool Robot::append_native_arc(const float target[], const float center[], float angular_travel, float rate_mm_s)
+{
+    const float quadrant= PI / 2;
+    float radius= hypotf(machine_position[this->plane_axis_0] - center[0], machine_position[this->plane_axis_1] - center[1]);
+    float start_angle= atan2f(machine_position[this->plane_axis_1] - center[1], machine_position[this->plane_axis_0] - center[0]);
+    float start[n_motors];
+    memcpy(start, machine_position, n_motors*sizeof(float));
+
+    bool moved= false;
+    float angle= 0; // turned so far
+    while(angle != angular_travel) {
+        if(THEKERNEL->is_halted()) return false; // don't queue any more segments
+
+        // the next place an axis changes direction, ignoring the one we are already at
+        float a= start_angle + angle;
+        float next;
+        if(angular_travel > 0) {
+            next= (floorf(a / quadrant + 0.0001F) + 1) * quadrant - start_angle;
+            if(next > angular_travel - 0.0001F) next= angular_travel;
+        }else{
+            next= (ceilf(a / quadrant - 0.0001F) - 1) * quadrant - start_angle;
+            if(next < angular_travel + 0.0001F) next= angular_travel;
+        }
+
+        ArcPath arc;
+        arc.axis[0]= this->plane_axis_0;
+        arc.axis[1]= this->plane_axis_1;
+        arc.center[0]= center[0];
+        arc.center[1]= center[1];
+        arc.angle= next - angle;
+
+        float arc_target[n_motors];
+        if(next == angular_travel) {
+            // ensure the last one arrives at the target location
+            memcpy(arc_target, target, n_motors*sizeof(float));
+
+        }else{
+            // the other axis move in proportion to the angle
+            float f= next / angular_travel;
+            for (int i = 0; i < n_motors; ++i) {
+                arc_target[i]= start[i] + (target[i] - start[i]) * f;
+            }
+            arc_target[this->plane_axis_0]= center[0] + radius * cosf(start_angle + next);
+            arc_target[this->plane_axis_1]= center[1] + radius * sinf(start_angle + next);
+        }
+
+        if(this->append_milestone(arc_target, rate_mm_s, &arc)) moved= true;
+        angle= next;
+    }
 
     return moved;
 }
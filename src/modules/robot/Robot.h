@@ -22,6 +22,7 @@ using std::string;
 class Gcode;
 class BaseSolution;
 class StepperMotor;
+struct ArcPath;
 
 // 9 WCS offsets
 #define MAX_WCS 9UL
@@ -32,6 +33,7 @@ class Robot : public Module {
         Robot();
         void on_module_loaded();
         void on_gcode_received(void* argument);
+        void on_idle(void* argument);
 
         void reset_axis_position(float position, int axis);
         void reset_axis_position(float x, float y, float z);
@@ -47,6 +49,8 @@ class Robot : public Module {
         void  push_state();
         void  pop_state();
         void check_max_actuator_speeds();
+        void flush_coalesced_line();
+        void drop_coalesced_line() { coalesce_count= 0; }
         float to_millimeters( float value ) const { return this->inch_mode ? value * 25.4F : value; }
         float from_millimeters( float value) const { return this->inch_mode ? value/25.4F : value;  }
         float get_axis_position(int axis) const { return(this->machine_position[axis]); }
@@ -59,6 +63,7 @@ class Robot : public Module {
         std::tuple<float, float, float, uint8_t> get_last_probe_position() const { return last_probe_position; }
         void set_last_probe_position(std::tuple<float, float, float, uint8_t> p) { last_probe_position = p; }
         bool delta_move(const float delta[], float rate_mm_s, uint8_t naxis);
+        const char *append_move(const float param[], float rate, float s, bool linear);
         uint8_t register_motor(StepperMotor*);
         uint8_t get_number_registered_motors() const {return n_motors; }
 
@@ -89,8 +94,12 @@ class Robot : public Module {
             bool save_g92:1;                                  // save g92 on M500 if set
             bool save_g54:1;                                  // save WCS on M500 if set
             bool is_g123:1;
+            bool speed_override_move:1;                       // the rate of the move being planned is scaled by M220
             bool soft_endstop_enabled:1;
             bool soft_endstop_halt:1;
+            bool coalesce_segment:1;                          // the pending coalesced line is to be segmented
+            bool independent_axes:1;                          // set if each primary axis drives its own actuator (cartesian)
+            bool native_arcs:1;                               // Setting : step arcs directly instead of cutting them into segments
             uint8_t plane_axis_0:2;                           // Current plane ( XY, XZ, YZ )
             uint8_t plane_axis_1:2;
             uint8_t plane_axis_2:2;
@@ -105,12 +114,38 @@ class Robot : public Module {
             CCW_ARC // G3
         };
 
+        // what append_line needs to know about where the line came from
+        enum LINE_FLAGS {
+            LINE_FEED= 0x01, // a G1, it can be merged and the extruder can limit its rate
+            LINE_XY= 0x02    // X or Y was given, without it the line is only segmented if segment_z_moves is set
+        };
+
+        // segment ends waiting to be passed through the arm solution together
+        static const uint8_t milestone_batch_size= 8;
+        struct milestone_batch_t {
+            uint8_t n{0};
+            float target[milestone_batch_size][k_max_actuators];      // as passed to append_milestone
+            float transformed[milestone_batch_size][k_max_actuators]; // after the compensation transform
+            ActuatorCoordinates actuator_pos[milestone_batch_size];
+        };
+
         void load_config();
-        bool append_milestone(const float target[], float rate_mm_s);
-        bool append_line( Gcode* gcode, const float target[], float rate_mm_s, float delta_e);
+        bool append_milestone(const float target[], float rate_mm_s, ArcPath *arc= nullptr, const float *transformed= nullptr, const ActuatorCoordinates *actuator_target= nullptr);
+        bool batch_milestone(milestone_batch_t& batch, const float target[], float rate_mm_s);
+        bool convert_milestones(milestone_batch_t& batch, uint8_t n);
+        bool flush_milestones(milestone_batch_t& batch, float rate_mm_s);
+        bool append_line(const float target[], float rate_mm_s, float delta_e, uint8_t flags, const char *raster_data, const char *&error);
+        bool append_segmented_line(const float start[], const float target[], float rate_mm_s, bool segment);
+        bool append_raster_line(const char *data, const float target[], float rate_mm_s, const char *&error);
+        bool append_adaptive_line(const float start[], const float target[], float rate_mm_s);
+        float segment_error(const float a[], const ActuatorCoordinates& actuator_a, const float b[], const ActuatorCoordinates& actuator_b) const;
+        bool coalesce_line(const float target[], float rate_mm_s, bool segment);
+        bool can_coalesce(const float target[]) const;
         bool append_arc( Gcode* gcode, const float target[], const float offset[], float radius, bool is_clockwise );
+        bool append_native_arc(const float target[], const float center[], float angular_travel, float rate_mm_s);
         bool compute_arc(Gcode* gcode, const float offset[], const float target[], enum MOTION_MODE_T motion_mode);
         void process_move(Gcode *gcode, enum MOTION_MODE_T);
+        void wcs_to_machine(const float param[], float target[]) const;
         bool is_homed(uint8_t i) const;
 
         float theta(float x, float y);
@@ -135,7 +170,10 @@ class Robot : public Module {
         float mm_per_line_segment;                           // Setting : Used to split lines into segments
         float mm_per_arc_segment;                            // Setting : Used to split arcs into segments
         float mm_max_arc_error;                              // Setting : Used to limit total arc segments to max error
+        float mm_max_coalesce_error;                         // Setting : Used to merge nearly collinear lines, 0 disables it
         float delta_segments_per_second;                     // Setting : Used to split lines into segments for delta based on speed
+        float mm_max_segment_error;                          // Setting : Used to split lines into segments for delta or scara based on the path error
+        float mm_min_segment_length;                         // Setting : the shortest segment mm_max_segment_error splits a line into
         float seconds_per_minute;                            // for realtime speed change
         float default_acceleration;                          // the defualt accleration if not set for each axis
         float s_value;                                       // modal S value
@@ -153,6 +191,20 @@ class Robot : public Module {
 
         uint8_t n_motors;                                    //count of the motors/axis registered
 
+        // G1 lines that are being merged into one line before they are planned
+        static const uint8_t max_coalesce= 16;
+        float coalesce_start[k_max_actuators];               // start of the pending line
+        float coalesce_points[max_coalesce][k_max_actuators];// end points of the merged lines, the last one is the end of the pending line
+        float coalesce_rate;
+        float coalesce_s_value;
+        uint8_t coalesce_count;                              // number of lines merged, 0 if none are pending
+        uint32_t coalesce_time;                              // us_ticker_read() when the last line was merged
+        static const uint32_t coalesce_timeout_ms= 20;       // the pending line is planned if no line is merged into it for this long
+
+        // the pixels of a raster line while it is being appended, read by the planner
+        const uint8_t *raster{nullptr};
+        uint16_t raster_pixels{0};
+
         // Used by Planner
         friend class Planner;
 };
@@ -14,6 +14,11 @@ class BaseSolution {
         virtual ~BaseSolution() {};
         virtual void cartesian_to_actuator(const float[], ActuatorCoordinates &) const = 0;
         virtual void actuator_to_cartesian(const ActuatorCoordinates &, float[]) const = 0;
+        // converts n points that are stride floats apart, solutions can override this to share the work between the points
+        virtual void cartesian_to_actuators(const float cartesian_mm[], size_t stride, ActuatorCoordinates actuator_mm[], size_t n) const
+        {
+            for (size_t i = 0; i < n; ++i) cartesian_to_actuator(&cartesian_mm[i * stride], actuator_mm[i]);
+        }
         typedef std::map<char, float> arm_options_t;
         virtual bool set_optional(const arm_options_t& options) { return false; };
         virtual bool get_optional(arm_options_t& options, bool force_all= false) const { return false; };
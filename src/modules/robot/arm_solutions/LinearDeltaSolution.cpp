@@ -58,19 +58,23 @@ void LinearDeltaSolution::init()
 
 void LinearDeltaSolution::cartesian_to_actuator(const float cartesian_mm[], ActuatorCoordinates &actuator_mm ) const
 {
+    cartesian_to_actuators(cartesian_mm, 0, &actuator_mm, 1);
+}
 
-    actuator_mm[ALPHA_STEPPER] = sqrtf(this->arm_length_squared
-                                       - SQ(delta_tower1_x - cartesian_mm[X_AXIS])
-                                       - SQ(delta_tower1_y - cartesian_mm[Y_AXIS])
-                                      ) + cartesian_mm[Z_AXIS];
-    actuator_mm[BETA_STEPPER ] = sqrtf(this->arm_length_squared
-                                       - SQ(delta_tower2_x - cartesian_mm[X_AXIS])
-                                       - SQ(delta_tower2_y - cartesian_mm[Y_AXIS])
-                                      ) + cartesian_mm[Z_AXIS];
-    actuator_mm[GAMMA_STEPPER] = sqrtf(this->arm_length_squared
-                                       - SQ(delta_tower3_x - cartesian_mm[X_AXIS])
-                                       - SQ(delta_tower3_y - cartesian_mm[Y_AXIS])
-                                      ) + cartesian_mm[Z_AXIS];
+// the tower positions are only loaded once for all the points
+void LinearDeltaSolution::cartesian_to_actuators(const float cartesian_mm[], size_t stride, ActuatorCoordinates actuator_mm[], size_t n) const
+{
+    const float arm2= this->arm_length_squared;
+    const float t1x= delta_tower1_x, t1y= delta_tower1_y;
+    const float t2x= delta_tower2_x, t2y= delta_tower2_y;
+    const float t3x= delta_tower3_x, t3y= delta_tower3_y;
+
+    for (size_t i = 0; i < n; ++i, cartesian_mm += stride) {
+        const float x= cartesian_mm[X_AXIS], y= cartesian_mm[Y_AXIS], z= cartesian_mm[Z_AXIS];
+        actuator_mm[i][ALPHA_STEPPER] = sqrtf(arm2 - SQ(t1x - x) - SQ(t1y - y)) + z;
+        actuator_mm[i][BETA_STEPPER ] = sqrtf(arm2 - SQ(t2x - x) - SQ(t2y - y)) + z;
+        actuator_mm[i][GAMMA_STEPPER] = sqrtf(arm2 - SQ(t3x - x) - SQ(t3y - y)) + z;
+    }
 }
 
 void LinearDeltaSolution::actuator_to_cartesian(const ActuatorCoordinates &actuator_mm, float cartesian_mm[] ) const
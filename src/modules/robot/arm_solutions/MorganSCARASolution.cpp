@@ -60,51 +60,45 @@ float MorganSCARASolution::to_degrees(float radians) const
 
 void MorganSCARASolution::cartesian_to_actuator(const float cartesian_mm[], ActuatorCoordinates &actuator_mm ) const
 {
+    cartesian_to_actuators(cartesian_mm, 0, &actuator_mm, 1);
+}
 
-    float SCARA_pos[2],
-          SCARA_C2,
-          SCARA_S2,
-          SCARA_K1,
-          SCARA_K2,
-          SCARA_theta,
-          SCARA_psi;
-
-    SCARA_pos[X_AXIS] = (cartesian_mm[X_AXIS] - this->morgan_offset_x)  * this->morgan_scaling_x;  //Translate cartesian to tower centric SCARA X Y AND apply scaling factor from this offset.
-    SCARA_pos[Y_AXIS] = (cartesian_mm[Y_AXIS]  * this->morgan_scaling_y - this->morgan_offset_y);  // morgan_offset not to be confused with home offset. This makes the SCARA math work.
-    // Y has to be scaled before subtracting offset to ensure position on bed.
-
-    if (this->arm1_length == this->arm2_length)
-        SCARA_C2 = (SQ(SCARA_pos[X_AXIS]) + SQ(SCARA_pos[Y_AXIS]) - 2.0f * SQ(this->arm1_length)) / (2.0f * SQ(this->arm1_length));
-    else
-        SCARA_C2 = (SQ(SCARA_pos[X_AXIS]) + SQ(SCARA_pos[Y_AXIS]) - SQ(this->arm1_length) - SQ(this->arm2_length)) / (2.0f * this->arm1_length * this->arm2_length);
-
-    // SCARA position is undefined if abs(SCARA_C2) >=1
-    // In reality abs(SCARA_C2) >0.95 can be problematic.
-
-    if (SCARA_C2 > this->morgan_undefined_max)
-        SCARA_C2 = this->morgan_undefined_max;
-    else if (SCARA_C2 < -this->morgan_undefined_min)
-        SCARA_C2 = -this->morgan_undefined_min;
-
-
-    SCARA_S2 = sqrtf(1.0f - SQ(SCARA_C2));
-
-    SCARA_K1 = this->arm1_length + this->arm2_length * SCARA_C2;
-    SCARA_K2 = this->arm2_length * SCARA_S2;
-
-    SCARA_theta = (atan2f(SCARA_pos[X_AXIS], SCARA_pos[Y_AXIS]) - atan2f(SCARA_K1, SCARA_K2)) * -1.0f; // Morgan Thomas turns Theta in oposite direction
-    SCARA_psi   = atan2f(SCARA_S2, SCARA_C2);
-
-
-    actuator_mm[ALPHA_STEPPER] = to_degrees(SCARA_theta);             // Multiply by 180/Pi  -  theta is support arm angle
-
-    if (real_scara == true){
-        actuator_mm[BETA_STEPPER ] = 180 - to_degrees(SCARA_psi); // real scara
-    }else{
-        actuator_mm[BETA_STEPPER ] = to_degrees(SCARA_theta + SCARA_psi); // Morgan kinematics (dual arm)
+// the terms that only depend on the arm lengths are worked out once for all the points
+void MorganSCARASolution::cartesian_to_actuators(const float cartesian_mm[], size_t stride, ActuatorCoordinates actuator_mm[], size_t n) const
+{
+    const float C2_offset= SQ(this->arm1_length) + SQ(this->arm2_length);
+    const float C2_scale= 1.0f / (2.0f * this->arm1_length * this->arm2_length);
+
+    for (size_t i = 0; i < n; ++i, cartesian_mm += stride) {
+        float SCARA_pos[2];
+        SCARA_pos[X_AXIS] = (cartesian_mm[X_AXIS] - this->morgan_offset_x)  * this->morgan_scaling_x;  //Translate cartesian to tower centric SCARA X Y AND apply scaling factor from this offset.
+        SCARA_pos[Y_AXIS] = (cartesian_mm[Y_AXIS]  * this->morgan_scaling_y - this->morgan_offset_y);  // morgan_offset not to be confused with home offset. This makes the SCARA math work.
+        // Y has to be scaled before subtracting offset to ensure position on bed.
+
+        float SCARA_C2 = (SQ(SCARA_pos[X_AXIS]) + SQ(SCARA_pos[Y_AXIS]) - C2_offset) * C2_scale;
+
+        // SCARA position is undefined if abs(SCARA_C2) >=1
+        // In reality abs(SCARA_C2) >0.95 can be problematic.
+        if (SCARA_C2 > this->morgan_undefined_max)
+            SCARA_C2 = this->morgan_undefined_max;
+        else if (SCARA_C2 < -this->morgan_undefined_min)
+            SCARA_C2 = -this->morgan_undefined_min;
+
+        float SCARA_S2 = sqrtf(1.0f - SQ(SCARA_C2));
+        float SCARA_K1 = this->arm1_length + this->arm2_length * SCARA_C2;
+        float SCARA_K2 = this->arm2_length * SCARA_S2;
+
+        float SCARA_theta = (atan2f(SCARA_pos[X_AXIS], SCARA_pos[Y_AXIS]) - atan2f(SCARA_K1, SCARA_K2)) * -1.0f; // Morgan Thomas turns Theta in oposite direction
+        float SCARA_psi   = atan2f(SCARA_S2, SCARA_C2);
+
+        actuator_mm[i][ALPHA_STEPPER] = to_degrees(SCARA_theta);             // Multiply by 180/Pi  -  theta is support arm angle
+        if (real_scara == true){
+            actuator_mm[i][BETA_STEPPER ] = 180 - to_degrees(SCARA_psi); // real scara
+        }else{
+            actuator_mm[i][BETA_STEPPER ] = to_degrees(SCARA_theta + SCARA_psi); // Morgan kinematics (dual arm)
+        }
+        actuator_mm[i][GAMMA_STEPPER] = cartesian_mm[Z_AXIS];            // No inverse kinematics on Z - Position to add bed offset?
     }
-
-    actuator_mm[GAMMA_STEPPER] = cartesian_mm[Z_AXIS];            // No inverse kinematics on Z - Position to add bed offset?
 }
 
 void MorganSCARASolution::actuator_to_cartesian(const ActuatorCoordinates &actuator_mm, float cartesian_mm[] ) const
@@ -10,6 +10,7 @@ class MorganSCARASolution : public BaseSolution {
         MorganSCARASolution(Config*);
         void cartesian_to_actuator(const float[], ActuatorCoordinates &) const override;
         void actuator_to_cartesian(const ActuatorCoordinates &, float[] ) const override;
+        void cartesian_to_actuators(const float[], size_t, ActuatorCoordinates[], size_t) const override;
 
         bool set_optional(const arm_options_t& options) override;
         bool get_optional(arm_options_t& options, bool force_all) const override;
@@ -13,6 +13,7 @@
 #include "modules/robot/Conveyor.h"
 #include "modules/robot/Block.h"
 #include "StepperMotor.h"
+#include "StepTicker.h"
 #include "SlowTicker.h"
 #include "Config.h"
 #include "StepperMotor.h"
@@ -45,6 +46,7 @@
 #define retract_recover_feedrate_checksum    CHECKSUM("retract_recover_feedrate")
 #define retract_zlift_length_checksum        CHECKSUM("retract_zlift_length")
 #define retract_zlift_feedrate_checksum      CHECKSUM("retract_zlift_feedrate")
+#define pressure_advance_checksum            CHECKSUM("pressure_advance")
 
 #define PI 3.14159265358979F
 
@@ -107,6 +109,7 @@ void Extruder::config_load()
     this->retract_recover_feedrate = THEKERNEL->config->value(extruder_checksum, this->identifier, retract_recover_feedrate_checksum)->by_default(8)->as_number();
     this->retract_zlift_length     = THEKERNEL->config->value(extruder_checksum, this->identifier, retract_zlift_length_checksum)->by_default(0)->as_number();
     this->retract_zlift_feedrate   = THEKERNEL->config->value(extruder_checksum, this->identifier, retract_zlift_feedrate_checksum)->by_default(100 * 60)->as_number() / 60.0F; // mm/min
+    this->pressure_advance         = THEKERNEL->config->value(extruder_checksum, this->identifier, pressure_advance_checksum)->by_default(0)->as_number(); // seconds
 
     if(filament_diameter > 0.01F) {
         this->volumetric_multiplier = 1.0F / (powf(this->filament_diameter / 2, 2) * PI);
@@ -121,6 +124,7 @@ void Extruder::config_load()
     stepper_motor->change_steps_per_mm(steps_per_millimeter);
     stepper_motor->set_selected(false); // not selected by default
     stepper_motor->set_extruder(true);  // indicates it is an extruder
+    THEKERNEL->step_ticker->set_pressure_advance(motor_id, pressure_advance);
 }
 
 void Extruder::select()
@@ -251,6 +255,7 @@ void Extruder::on_gcode_received(void *argument)
             if (gcode->has_letter('E')) {
                 spm = gcode->get_value('E');
                 stepper_motor->change_steps_per_mm(spm);
+                THEKERNEL->step_ticker->set_pressure_advance(motor_id, pressure_advance);
             }
 
             gcode->stream->printf("E:%f ", spm);
@@ -289,6 +294,7 @@ void Extruder::on_gcode_received(void *argument)
             } else {
                 if(gcode->has_letter('E')) {
                     this->stepper_motor->set_max_rate(gcode->get_value('E'));
+                    THEKERNEL->step_ticker->set_pressure_advance(motor_id, pressure_advance);
                 }
                 if(gcode->has_letter('V')) {
                     this->max_volumetric_rate = gcode->get_value('V');
@@ -312,6 +318,16 @@ void Extruder::on_gcode_received(void *argument)
             if(gcode->has_letter('S')) retract_recover_length = gcode->get_value('S');
             if(gcode->has_letter('F')) retract_recover_feedrate = gcode->get_value('F') / 60.0F; // specified in mm/min converted to mm/sec
 
+        } else if (gcode->m == 900 && ( (this->selected && !gcode->has_letter('P')) || (gcode->has_letter('P') && gcode->get_value('P') == this->identifier)) ) {
+            // M900 K[seconds] - set pressure advance, 0 turns it off
+            if(gcode->has_letter('K')) {
+                this->pressure_advance = gcode->get_value('K');
+                THEKERNEL->step_ticker->set_pressure_advance(motor_id, pressure_advance);
+
+            } else {
+                gcode->stream->printf("Pressure advance: %g s\n", this->pressure_advance);
+            }
+
         } else if (gcode->m == 221 && this->selected) { // M221 S100 change flow rate by percentage
             if(gcode->has_letter('S')) {
                 float last_scale = this->extruder_multiplier;
@@ -334,6 +350,7 @@ void Extruder::on_gcode_received(void *argument)
             gcode->stream->printf(";E retract recover length, feedrate:\nM208 S%1.4f F%1.4f P%d\n", this->retract_recover_length, this->retract_recover_feedrate * 60.0F, this->identifier);
             gcode->stream->printf(";E acceleration mm/sec²:\nM204 E%1.4f P%d\n", stepper_motor->get_acceleration(), this->identifier);
             gcode->stream->printf(";E max feed rate mm/sec:\nM203 E%1.4f P%d\n", stepper_motor->get_max_rate(), this->identifier);
+            gcode->stream->printf(";E pressure advance seconds:\nM900 K%1.4f P%d\n", this->pressure_advance, this->identifier);
             if(this->max_volumetric_rate > 0) {
                 gcode->stream->printf(";E max volumetric rate mm³/sec:\nM203 V%1.4f P%d\n", this->max_volumetric_rate, this->identifier);
             }
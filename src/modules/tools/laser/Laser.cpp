@@ -41,6 +41,7 @@
 #define laser_module_tickle_power_checksum      CHECKSUM("laser_module_tickle_power")
 #define laser_module_max_power_checksum         CHECKSUM("laser_module_max_power")
 #define laser_module_maximum_s_value_checksum   CHECKSUM("laser_module_maximum_s_value")
+#define laser_module_sync_steps_checksum        CHECKSUM("laser_module_sync_steps")
 
 
 Laser::Laser()
@@ -49,6 +50,7 @@ Laser::Laser()
     laser_on = false;
     scale = 1;
     manual_fire = false;
+    step_synced = false;
     fire_duration = 0;
     identifier=laser_checksum;
     x_stepper=NULL;
@@ -143,6 +145,13 @@ void Laser::on_module_loaded()
     ms_per_tick = 1000 / std::min(1000UL, 1000000 / period);
     THEKERNEL->slow_ticker->attach(std::min(1000UL, 1000000 / period), this, &Laser::set_proportional_power);
 
+    // if set the power is updated from the step ticker every this many steps of the fastest moving axis instead, so it follows acceleration exactly
+    uint32_t sync_steps = THEKERNEL->config->value(laser_module_sync_steps_checksum)->by_default(0)->as_number();
+    this->step_synced = sync_steps > 0;
+    if(this->step_synced) {
+        THEKERNEL->step_ticker->set_step_sync([this]() { this->update_proportional_power(); }, sync_steps);
+    }
+
     THEKERNEL->tool_manager->add_tool( this );
 }
 
@@ -258,11 +267,24 @@ float Laser::current_speed_ratio(const Block *block) const
 
     // figure out the ratio of its speed, from 0 to 1 based on where it is on the trapezoid,
     // this is based on the fraction it is of the requested rate (nominal rate)
-    float ratio = block->get_trapezoid_rate(pm) / block->nominal_rate;
+    // NOTE on an arc the nominal rate is for the steps along the arc so it is scaled to this actuator
+    float ratio = block->get_trapezoid_rate(pm) / (block->nominal_rate * max_steps / block->steps_event_count);
 
     return ratio;
 }
 
+// the power of the pixel the primary actuator has got to on a raster line, they are spread evenly over its steps
+uint8_t Laser::current_raster_pixel(const Block *block) const
+{
+    for (uint8_t i = 0; i < block->n_active; i++) {
+        const Block::tickinfo_t& ti = block->tick_info[i];
+        if(ti.steps_to_move != block->steps_event_count) continue;
+        uint32_t pixel = (uint64_t)ti.step_count * block->raster_pixels / ti.steps_to_move;
+        return block->raster()[std::min<uint32_t>(pixel, block->raster_pixels - 1)];
+    }
+    return 0;
+}
+
 // get laser power for the currently executing block, returns false if nothing running or a G0
 bool Laser::get_laser_power(float& power) const
 {
@@ -272,8 +294,10 @@ bool Laser::get_laser_power(float& power) const
     // as this is an interrupt if that flag is not clear then it cannot be cleared while this is running and the block will still be valid (albeit it may have finished)
     if(block != nullptr && block->is_ready && block->is_g123) {
         float requested_power = ((float)block->s_value / (1 << 11)) / this->laser_maximum_s_value; // s_value is 1.11 Fixed point
-        float ratio = current_speed_ratio(block);
+        // a feed hold slows the move down without changing the block so the power follows it down too
+        float ratio = current_speed_ratio(block) * StepTicker::getInstance()->get_hold_scale();
         power = requested_power * ratio * scale;
+        if(block->raster_pixels > 0) power *= current_raster_pixel(block) / 255.0F;
 
         return true;
     }
@@ -300,6 +324,16 @@ uint32_t Laser::set_proportional_power(uint32_t dummy)
         return 0;
     }
 
+    // the step ticker does this when the power is step synced
+    if(!step_synced) update_proportional_power();
+    return 0;
+}
+
+// sets the power from the speed of the currently executing block, called from either the slow ticker or the step ticker
+void Laser::update_proportional_power()
+{
+    if (!selected || manual_fire) return;
+
     float power;
     if(get_laser_power(power)) {
         // adjust power to maximum power and actual velocity
@@ -310,7 +344,6 @@ uint32_t Laser::set_proportional_power(uint32_t dummy)
         // turn laser off
         set_laser_power(0);
     }
-    return 0;
 }
 
 bool Laser::set_laser_power(float power)
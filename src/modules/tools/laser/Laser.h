@@ -38,8 +38,10 @@ class Laser : public Tool {
 
     private:
         uint32_t set_proportional_power(uint32_t dummy);
+        void update_proportional_power();
         bool get_laser_power(float& power) const;
         float current_speed_ratio(const Block *block) const;
+        uint8_t current_raster_pixel(const Block *block) const;
 
         mbed::PwmOut *pwm_pin;    // PWM output to regulate the laser power
         Pin *ttl_pin;				// TTL output to fire laser
@@ -56,5 +58,6 @@ class Laser : public Tool {
             bool ttl_used:1;        // stores whether we have a TTL output
             bool ttl_inverting:1;   // stores whether the TTL output should be inverted
             bool manual_fire:1;     // set when manually firing
+            bool step_synced:1;     // set when the power is updated from the step ticker
         };
 };
@@ -41,6 +41,7 @@
 #include "md5.h"
 #include "utils.h"
 #include "AutoPushPop.h"
+#include "IsrTiming.h"
 
 #include "system_LPC17xx.h"
 #include "LPC17xx.h"
@@ -78,6 +79,7 @@ const SimpleShell::ptentry_t SimpleShell::commands_table[] = {
     {"?",        SimpleShell::help_command},
     {"version",  SimpleShell::version_command},
     {"mem",      SimpleShell::mem_command},
+    {"isr",      SimpleShell::isr_command},
     {"get",      SimpleShell::get_command},
     {"set_temp", SimpleShell::set_temp_command},
     {"switch",   SimpleShell::switch_command},
@@ -615,7 +617,27 @@ void SimpleShell::mem_command( string parameters, StreamOutput *stream)
         AHB1.debug(stream);
     }
 
-    stream->printf("Block size: %u bytes, Tickinfo size: %u bytes\n", sizeof(Block), sizeof(Block::tickinfo_t) * Block::n_actuators);
+    stream->printf("Block size: %u bytes, Tickinfo size: %u bytes per moving motor\n", sizeof(Block), sizeof(Block::tickinfo_t) + sizeof(Block::rampinfo_t));
+}
+
+// isr [on|off|reset] - times the motion interrupts, prints the timings if no parameter
+void SimpleShell::isr_command( string parameters, StreamOutput *stream)
+{
+    string p = shift_parameter( parameters );
+    if(p == "on") {
+        IsrTiming::enable(true);
+    }else if(p == "off") {
+        IsrTiming::enable(false);
+    }else if(p == "reset") {
+        IsrTiming::reset();
+    }else if(p.empty()) {
+        IsrTiming::print(stream);
+        return;
+    }else{
+        stream->printf("usage: isr [on|off|reset]\n");
+        return;
+    }
+    stream->printf("isr timing is %s\n", IsrTiming::is_enabled() ? "on" : "off");
 }
 
 static uint32_t getDeviceType()
@@ -889,7 +911,11 @@ void SimpleShell::get_command( string parameters, StreamOutput *stream)
 
     } else if (what == "status") {
         // also ? on serial and usb
-        stream->printf("%s\n", THEKERNEL->get_query_string().c_str());
+        stream->printf("%s\n", THEKERNEL->get_query_string(stream).c_str());
+
+    } else if (what == "queue") {
+        // how much motion is buffered ahead of the step ticker
+        stream->printf("queued: %1.1f ms, starvations: %lu\n", THECONVEYOR->get_queued_time() * 1000.0F, THECONVEYOR->get_starvation_count());
 
     } else {
         stream->printf("error:unknown option %s\n", what.c_str());
@@ -1330,6 +1356,7 @@ void SimpleShell::help_command( string parameters, StreamOutput *stream )
     stream->printf("Commands:\r\n");
     stream->printf("version\r\n");
     stream->printf("mem [-v]\r\n");
+    stream->printf("isr [on|off|reset] - time the step, unstep, pendsv and slow ticker interrupts, prints the timings if no parameter\r\n");
     stream->printf("ls [-s] [folder]\r\n");
     stream->printf("cd folder\r\n");
     stream->printf("pwd\r\n");
@@ -1344,7 +1371,7 @@ void SimpleShell::help_command( string parameters, StreamOutput *stream )
     stream->printf("dfu - enter dfu boot loader\r\n");
     stream->printf("break - break into debugger\r\n");
     stream->printf("config-set [<configuration_source>] <configuration_setting> <value>\r\n");
-    stream->printf("get [pos|wcs|state|status|fk|ik]\r\n");
+    stream->printf("get [pos|wcs|state|status|queue|fk|ik]\r\n");
     stream->printf("get temp [bed|hotend]\r\n");
     stream->printf("set_temp bed|hotend 185\r\n");
     stream->printf("switch name [value]\r\n");
@@ -0,0 +1,66 @@
+#include "BinaryProtocol.h"
+#include "StreamOutput.h"
+#include "Test_kernel.h"
+
+#include <string>
+#include <string.h>
+
+#include "easyunit/test.h"
+
+// keeps what is printed so the errors can be checked
+class StringStreamOutput : public StreamOutput {
+    public:
+        int puts(const char *str) { s.append(str); return strlen(str); }
+        std::string s;
+};
+
+// a frame with the given type and payload and a good crc
+static size_t make_frame(uint8_t *frame, uint8_t type, const uint8_t *payload, uint8_t len)
+{
+    frame[0]= BinaryProtocol::sync;
+    frame[1]= type;
+    frame[2]= len;
+    memcpy(&frame[3], payload, len);
+    uint16_t crc= BinaryProtocol::crc16(&frame[1], len + 2);
+    frame[len + 3]= crc & 0xFF;
+    frame[len + 4]= crc >> 8;
+    return len + BinaryProtocol::overhead;
+}
+
+TEST(BinaryProtocol,crc16)
+{
+    // the check value of CRC-16/CCITT-FALSE
+    ASSERT_EQUALS_V(0x29B1, BinaryProtocol::crc16((const uint8_t *)"123456789", 9));
+    ASSERT_EQUALS_V(0xFFFF, BinaryProtocol::crc16(nullptr, 0));
+}
+
+TEST(BinaryProtocol,bad_frames_halt)
+{
+    uint8_t frame[BinaryProtocol::max_payload + BinaryProtocol::overhead];
+    const uint8_t payload[]= {BinaryProtocol::LINEAR, 0x01, 0x10, 0x27, 0x00, 0x00};
+    size_t len= make_frame(frame, BinaryProtocol::MOVE, payload, sizeof(payload));
+
+    int halts= 0;
+    test_kernel_trap_event(ON_HALT, [&halts](void *) { ++halts; });
+
+    StringStreamOutput out;
+    ASSERT_TRUE(!BinaryProtocol::handle_frame(frame, len - 1, &out));
+    ASSERT_TRUE(out.s.find("Bad binary frame length") != std::string::npos);
+    ASSERT_EQUALS_V(1, halts);
+
+    // too long for a payload
+    out.s.clear();
+    frame[2]= BinaryProtocol::max_payload + 1;
+    ASSERT_TRUE(!BinaryProtocol::handle_frame(frame, 3, &out));
+    ASSERT_TRUE(out.s.find("Bad binary frame length") != std::string::npos);
+    ASSERT_EQUALS_V(2, halts);
+
+    out.s.clear();
+    len= make_frame(frame, BinaryProtocol::MOVE, payload, sizeof(payload));
+    frame[5] ^= 0x01;
+    ASSERT_TRUE(!BinaryProtocol::handle_frame(frame, len, &out));
+    ASSERT_TRUE(out.s.find("Bad binary frame crc") != std::string::npos);
+    ASSERT_EQUALS_V(3, halts);
+
+    test_kernel_teardown();
+}
@@ -0,0 +1,47 @@
+#include "GcodeDispatch.h"
+
+#include <string>
+
+#include "easyunit/test.h"
+
+TEST(GcodeDispatch,scan_numbered_line)
+{
+    int ln;
+    size_t start, end;
+    std::string line("N3 M105");
+    ASSERT_TRUE(GcodeDispatch::scan_numbered_line(line, ln, start, end));
+    ASSERT_EQUALS_V(3, ln);
+    ASSERT_TRUE(line.substr(start, end - start) == "M105");
+}
+
+TEST(GcodeDispatch,scan_numbered_line_checksum)
+{
+    int ln;
+    size_t start, end;
+    std::string line("N10 G1 X10 Y20*27");
+    ASSERT_TRUE(GcodeDispatch::scan_numbered_line(line, ln, start, end));
+    ASSERT_EQUALS_V(10, ln);
+    ASSERT_TRUE(line.substr(start, end - start) == "G1 X10 Y20");
+
+    // one bit different in the line or the checksum
+    ASSERT_TRUE(!GcodeDispatch::scan_numbered_line("N10 G1 X10 Y21*27", ln, start, end));
+    ASSERT_TRUE(!GcodeDispatch::scan_numbered_line("N10 G1 X10 Y20*26", ln, start, end));
+    ASSERT_TRUE(!GcodeDispatch::scan_numbered_line("N10 G1 X10 Y20*", ln, start, end));
+}
+
+TEST(GcodeDispatch,scan_numbered_line_comment)
+{
+    int ln;
+    size_t start, end;
+
+    // the comment is part of the checksum but not of the command
+    std::string line("N5 G1 X1 ;move*110");
+    ASSERT_TRUE(GcodeDispatch::scan_numbered_line(line, ln, start, end));
+    ASSERT_EQUALS_V(5, ln);
+    ASSERT_TRUE(line.substr(start, end - start) == "G1 X1 ");
+
+    line= "N6 G1 X2 (move)";
+    ASSERT_TRUE(GcodeDispatch::scan_numbered_line(line, ln, start, end));
+    ASSERT_EQUALS_V(6, ln);
+    ASSERT_TRUE(line.substr(start, end - start) == "G1 X2 ");
+}
@@ -60,3 +60,45 @@ TEST(GCodeTest,subcode)
     ASSERT_EQUALS_DELTA_V(2.3, gc4.get_value('Y'), 0.001);
 
 }
+
+TEST(GCodeTest,args)
+{
+    Gcode gc1("G1 X1.5 Y-2 E0.25 F3000 Z", nullptr);
+    ASSERT_EQUALS_V(1, gc1.g);
+    ASSERT_EQUALS_V(5, gc1.get_num_args());
+    ASSERT_EQUALS_DELTA_V(1.5, gc1.get_value('X'), 0.001);
+    ASSERT_EQUALS_DELTA_V(-2.0, gc1.get_value('Y'), 0.001);
+    ASSERT_EQUALS_DELTA_V(0.25, gc1.get_value('E'), 0.001);
+    ASSERT_EQUALS_V(3000, gc1.get_int('F'));
+    ASSERT_EQUALS_V(3000, gc1.get_uint('F'));
+    // a letter with no number is there but has a value of 0
+    ASSERT_TRUE(gc1.has_letter('Z'));
+    ASSERT_EQUALS_DELTA_V(0.0, gc1.get_value('Z'), 0.001);
+    ASSERT_TRUE(!gc1.has_letter('G'));
+    ASSERT_TRUE(!gc1.has_letter('A'));
+    ASSERT_EQUALS_DELTA_V(0.0, gc1.get_value('A'), 0.001);
+
+    // the first occurrence with a number is used
+    Gcode gc2("M117 S S12 S34", nullptr);
+    ASSERT_EQUALS_V(117, gc2.m);
+    ASSERT_EQUALS_V(12, gc2.get_int('S'));
+
+    // a line too long to fit in the object
+    Gcode gc3("M118 P1 this is a message that is much longer than the space kept for short gcodes Q2.5", nullptr);
+    ASSERT_EQUALS_V(118, gc3.m);
+    ASSERT_EQUALS_V(1, gc3.get_int('P'));
+    ASSERT_EQUALS_DELTA_V(2.5, gc3.get_value('Q'), 0.001);
+    ASSERT_TRUE(strncmp(gc3.get_command(), " P1 this is", 11) == 0);
+    Gcode gc4(gc3);
+    ASSERT_EQUALS_DELTA_V(2.5, gc4.get_value('Q'), 0.001);
+    gc4= gc1;
+    ASSERT_EQUALS_DELTA_V(1.5, gc4.get_value('X'), 0.001);
+    ASSERT_TRUE(gc4.has_letter('Z'));
+    ASSERT_TRUE(!gc4.has_letter('P'));
+
+    // not stripped, and a letter that is not an argument
+    Gcode gc5("N10 G1 X2*45", nullptr, false);
+    ASSERT_EQUALS_V(10, gc5.get_int('N'));
+    ASSERT_EQUALS_V(45, gc5.get_int('*'));
+    ASSERT_TRUE(gc5.has_letter('G'));
+}
@@ -45,3 +45,44 @@ TEST(UtilsTest,append_parameters)
     ASSERT_TRUE(n == 24);
     ASSERT_TRUE(strcmp(buf, "X1.0000 Y2.0000 Z3.0000 ") == 0);
 }
+
+TEST(UtilsTest,parse_hex_bytes)
+{
+    uint8_t buf[8];
+    const char *s= "00407fbfFF";
+    size_t n= parse_hex_bytes(s, buf, sizeof(buf));
+    ASSERT_EQUALS_V(5, (int)n);
+    ASSERT_EQUALS_V(0x00, buf[0]);
+    ASSERT_EQUALS_V(0x40, buf[1]);
+    ASSERT_EQUALS_V(0x7f, buf[2]);
+    ASSERT_EQUALS_V(0xbf, buf[3]);
+    ASSERT_EQUALS_V(0xff, buf[4]);
+    ASSERT_TRUE(s[2 * n] == '\0');
+}
+
+TEST(UtilsTest,parse_hex_bytes_stops)
+{
+    uint8_t buf[4];
+
+    // stops at the first character that is not hex
+    const char *s= "0a1b X10";
+    size_t n= parse_hex_bytes(s, buf, sizeof(buf));
+    ASSERT_EQUALS_V(2, (int)n);
+    ASSERT_TRUE(s[2 * n] == ' ');
+
+    // an odd digit at the end is left for the caller to find
+    s= "0a1b2";
+    n= parse_hex_bytes(s, buf, sizeof(buf));
+    ASSERT_EQUALS_V(2, (int)n);
+    ASSERT_TRUE(s[2 * n] == '2');
+
+    // does not go past the end of buf, what is left is still hex
+    s= "00112233445566";
+    n= parse_hex_bytes(s, buf, sizeof(buf));
+    ASSERT_EQUALS_V(4, (int)n);
+    ASSERT_EQUALS_V(0x33, buf[3]);
+    ASSERT_TRUE(s[2 * n] == '4');
+
+    ASSERT_EQUALS_V(0, (int)parse_hex_bytes("", buf, sizeof(buf)));
+    ASSERT_EQUALS_V(0, (int)parse_hex_bytes("g0", buf, sizeof(buf)));
+}